@@ -62,9 +62,9 @@ MainWindow::MainWindow(QWidget *parent)
     for(const auto& type : {"Basic", "Low", "Middle", "High"})
         ui->SensorSettingPhCalType->addItem(type);
 
-    plot(ui->SensorPlotTemp, &m_temp, &m_tempPlotSettings);
-    plot(ui->SensorPlotPh, &m_ph, &m_phPlotSettings);
-    plot(ui->SensorPlotTds, &m_tds, &m_tdsPlotSettings);
+    setup_plot(ui->SensorPlotTemp, &m_tempPlotSettings);
+    setup_plot(ui->SensorPlotPh, &m_phPlotSettings);
+    setup_plot(ui->SensorPlotTds, &m_tdsPlotSettings);
 
     setWindowTitle("Water Research GUI");
 }
@@ -171,17 +171,17 @@ void MainWindow::parse_data()
     if (message[1] == m_tempPlotSettings.typeSensor)
     {
         add_value(&m_temp, value);
-        plot(ui->SensorPlotTemp, &m_temp, &m_tempPlotSettings);
+        plot(ui->SensorPlotTemp, &m_temp);
     }
     else if (message[1] == m_phPlotSettings.typeSensor)
     {
         add_value(&m_ph, value);
-        plot(ui->SensorPlotPh, &m_ph, &m_phPlotSettings);
+        plot(ui->SensorPlotPh, &m_ph);
     }
     else if (message[1] == m_tdsPlotSettings.typeSensor)
     {
         add_value(&m_tds, value);
-        plot(ui->SensorPlotTds, &m_tds, &m_tdsPlotSettings);
+        plot(ui->SensorPlotTds, &m_tds);
     }
 }
 
@@ -206,12 +206,10 @@ void MainWindow::add_value(QVector<double> *arr, double value)
     }
 }
 
-void MainWindow::plot(QCustomPlot *plot, const QVector<double> *arr, const Ui::PlotSettings *settings)
+void MainWindow::setup_plot(QCustomPlot *plot, const Ui::PlotSettings *settings)
 {
     plot->addGraph();
-
     plot->graph(0)->setPen(QPen(Qt::black));
-    plot->graph(0)->setData(m_t, *arr);
 
     plot->xAxis->setRange(0,100);
     plot->xAxis->setVisible(false);
@@ -219,6 +217,16 @@ void MainWindow::plot(QCustomPlot *plot, const QVector<double> *arr, const Ui::P
     plot->yAxis->setRange(settings->min, settings->max);
     plot->yAxis->ticker()->setTickCount(8);
 
+    /* Only the graph changes with new samples, so it gets its own buffer and the rest is reused */
+    plot->layer("main")->setMode(QCPLayer::lmBuffered);
+    plot->setPlottingHint(QCP::phSkipStaticLayers);
+
+    plot->replot();
+}
+
+void MainWindow::plot(QCustomPlot *plot, const QVector<double> *arr)
+{
+    plot->graph(0)->setData(m_t.mid(0, arr->size()), *arr, true);
     plot->replot();
 }
 
@@ -80,7 +80,8 @@ private slots:
 private:
     void set_serial();
     void add_value(QVector<double> *arr, double value);
-    void plot(QCustomPlot *plot, const QVector<double> *arr, const Ui::PlotSettings *settings);
+    void setup_plot(QCustomPlot *plot, const Ui::PlotSettings *settings);
+    void plot(QCustomPlot *plot, const QVector<double> *arr);
     quint8 get_sum(const quint8 *arr, quint8 len);
     void send_data(quint8 typeSensor, const quint8 *data);
 
@@ -488,6 +488,297 @@ void QCPPainter::makeNonCosmetic()
 /* end of 'src/painter.cpp' */
 
 
+/* including file 'src/linerasterizer.cpp' */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPLineRasterizer
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPLineRasterizer
+  \brief Draws thin solid lines directly into the QImage a QCPPainter paints on
+
+  QPainter strokes every line through its general path stroking machinery, which is comparatively
+  slow for the common case of plottables with a solid cosmetic pen and tens of thousands of line
+  segments. This class bypasses QPainter for exactly that case and writes the line pixels directly
+  into the target image, using Bresenham's algorithm for aliased lines and Xiaolin Wu's algorithm
+  for antialiased lines. Pixels are blended with the source-over composition in premultiplied ARGB.
+
+  It is used by \ref QCPAbstractPlottable1D::drawPolyline, if the plotting hint \ref
+  QCP::phRasterizeLines is set. In that case, QCustomPlot also uses QImage based paint buffers (\ref
+  QCPPaintBufferImage), so the painter passed to the layerables paints onto a QImage.
+
+  A rasterizer instance captures the state of the painter (pen color, opacity, antialiasing,
+  transform and clip rect) upon construction, and is only valid (\ref isValid) if the painter state
+  allows the fast path:
+  \li the painter is active on a QImage of format \c Format_ARGB32_Premultiplied or \c Format_RGB32
+  \li the pen is solid, has a solid color brush and is cosmetic with a width of at most one pixel
+  \li the composition mode is \c CompositionMode_SourceOver
+  \li the transform consists only of translation and scaling
+  \li the clip region (if any) is a single rect
+  
+  If it isn't valid, the caller must fall back to drawing with QPainter.
+*/
+
+/*!
+  Creates a rasterizer which draws with the current state of \a painter. Check \ref isValid before
+  drawing.
+*/
+QCPLineRasterizer::QCPLineRasterizer(QCPPainter *painter) :
+  mImage(nullptr),
+  mBits(nullptr),
+  mBytesPerLine(0),
+  mColor(0),
+  mAntialiased(false),
+  mScaleX(1),
+  mScaleY(1),
+  mDx(0),
+  mDy(0)
+{
+  if (!painter || !painter->isActive() || !painter->device() || painter->device()->devType() != QInternal::Image)
+    return;
+  QImage *image = static_cast<QImage*>(painter->device());
+  if (image->format() != QImage::Format_ARGB32_Premultiplied && image->format() != QImage::Format_RGB32)
+    return;
+  const QPen pen = painter->pen();
+  if (pen.style() != Qt::SolidLine || pen.brush().style() != Qt::SolidPattern || !pen.isCosmetic() || pen.widthF() > 1.0)
+    return;
+  if (painter->compositionMode() != QPainter::CompositionMode_SourceOver)
+    return;
+  const QTransform transform = painter->deviceTransform();
+  if (transform.type() > QTransform::TxScale)
+    return;
+  mClip = image->rect();
+  if (painter->hasClipping())
+  {
+    const QRegion clipRegion = painter->clipRegion();
+    if (clipRegion.rectCount() > 1)
+      return;
+    mClip &= transform.mapRect(QRectF(clipRegion.boundingRect())).toAlignedRect();
+  }
+  
+  QColor color = pen.color();
+  color.setAlphaF(color.alphaF()*painter->opacity());
+  mColor = qPremultiply(color.rgba());
+  mAntialiased = painter->testRenderHint(QPainter::Antialiasing);
+  mScaleX = transform.m11();
+  mScaleY = transform.m22();
+  mDx = transform.dx();
+  mDy = transform.dy();
+  mClipF = QRectF(mClip.left()-1, mClip.top()-1, mClip.width()+2, mClip.height()+2);
+  mBits = image->bits();
+  mBytesPerLine = image->bytesPerLine();
+  mImage = image;
+}
+
+/*!
+  Draws the polyline through the \a pointCount points starting at \a points, given in the logical
+  coordinates of the painter. Joint pixels of consecutive segments are only drawn once, so
+  translucent pens don't show darker spots at the data points.
+
+  The points must be finite, i.e. the caller must split the polyline at NaN and infinite values.
+*/
+void QCPLineRasterizer::drawPolyline(const QPointF *points, int pointCount)
+{
+  if (!mImage)
+    return;
+  for (int i=1; i<pointCount; ++i)
+    drawLine(points[i-1], points[i], i == pointCount-1);
+}
+
+/*!
+  Draws the line from \a p1 to \a p2, given in the logical coordinates of the painter. If \a
+  includeLast is false, the pixel at \a p2 is not drawn, which is used to draw polylines without
+  blending the joint pixels twice.
+*/
+void QCPLineRasterizer::drawLine(const QPointF &p1, const QPointF &p2, bool includeLast)
+{
+  if (!mImage)
+    return;
+  double x1 = p1.x()*mScaleX + mDx;
+  double y1 = p1.y()*mScaleY + mDy;
+  double x2 = p2.x()*mScaleX + mDx;
+  double y2 = p2.y()*mScaleY + mDy;
+  if (!clipLine(x1, y1, x2, y2))
+    return;
+  if (mAntialiased)
+    drawLineAntialiased(x1, y1, x2, y2, includeLast);
+  else
+    drawLineAliased(x1, y1, x2, y2, includeLast);
+}
+
+/*! \internal
+
+  Clips the line from (\a x1, \a y1) to (\a x2, \a y2), given in device pixels, to the clip rect
+  enlarged by one pixel on each side (Liang-Barsky). This keeps the pixel loops short for lines
+  that reach far outside the visible area. Returns false if the line is completely outside.
+*/
+bool QCPLineRasterizer::clipLine(double &x1, double &y1, double &x2, double &y2) const
+{
+  const double dx = x2-x1;
+  const double dy = y2-y1;
+  const double p[4] = {-dx, dx, -dy, dy};
+  const double q[4] = {x1-mClipF.left(), mClipF.right()-x1, y1-mClipF.top(), mClipF.bottom()-y1};
+  double t0 = 0;
+  double t1 = 1;
+  for (int i=0; i<4; ++i)
+  {
+    if (p[i] == 0)
+    {
+      if (q[i] < 0)
+        return false;
+    } else
+    {
+      const double r = q[i]/p[i];
+      if (p[i] < 0)
+      {
+        if (r > t1)
+          return false;
+        if (r > t0)
+          t0 = r;
+      } else
+      {
+        if (r < t0)
+          return false;
+        if (r < t1)
+          t1 = r;
+      }
+    }
+  }
+  if (t1 < 1)
+  {
+    x2 = x1 + t1*dx;
+    y2 = y1 + t1*dy;
+  }
+  if (t0 > 0)
+  {
+    x1 += t0*dx;
+    y1 += t0*dy;
+  }
+  return true;
+}
+
+/*! \internal
+
+  Draws an aliased line between the device pixel coordinates with Bresenham's algorithm. The pixel
+  covering a coordinate is the one with the floored coordinate, as with QPainter's aliased
+  drawing.
+*/
+void QCPLineRasterizer::drawLineAliased(double x1, double y1, double x2, double y2, bool includeLast)
+{
+  int ix = qFloor(x1);
+  int iy = qFloor(y1);
+  const int ixEnd = qFloor(x2);
+  const int iyEnd = qFloor(y2);
+  const int dx = qAbs(ixEnd-ix);
+  const int dy = -qAbs(iyEnd-iy);
+  const int sx = ix < ixEnd ? 1 : -1;
+  const int sy = iy < iyEnd ? 1 : -1;
+  int error = dx+dy;
+  while (ix != ixEnd || iy != iyEnd)
+  {
+    blendPixel(ix, iy, 255);
+    const int error2 = 2*error;
+    if (error2 >= dy)
+    {
+      error += dy;
+      ix += sx;
+    }
+    if (error2 <= dx)
+    {
+      error += dx;
+      iy += sy;
+    }
+  }
+  if (includeLast)
+    blendPixel(ixEnd, iyEnd, 255);
+}
+
+/*! \internal
+
+  Draws an antialiased line between the device pixel coordinates with Xiaolin Wu's algorithm: For
+  each pixel column (or row, for steep lines) the line intensity is distributed onto the two pixels
+  whose centers are closest to the line.
+*/
+void QCPLineRasterizer::drawLineAntialiased(double x1, double y1, double x2, double y2, bool includeLast)
+{
+  // pixel centers are at half-integer coordinates:
+  x1 -= 0.5;
+  y1 -= 0.5;
+  x2 -= 0.5;
+  y2 -= 0.5;
+  const bool steep = qAbs(y2-y1) > qAbs(x2-x1);
+  if (steep)
+  {
+    qSwap(x1, y1);
+    qSwap(x2, y2);
+  }
+  bool reversed = false;
+  if (x1 > x2)
+  {
+    qSwap(x1, x2);
+    qSwap(y1, y2);
+    reversed = true;
+  }
+  const double gradient = x2 > x1 ? (y2-y1)/(x2-x1) : 0;
+  int start = qRound(x1);
+  int end = qRound(x2);
+  if (!includeLast) // leave out the pixel at the original end point of the line
+  {
+    if (reversed)
+      ++start;
+    else
+      --end;
+  }
+  double y = y1 + gradient*(start-x1);
+  for (int x=start; x<=end; ++x)
+  {
+    const int iy = qFloor(y);
+    const int coverage = int((y-iy)*255+0.5);
+    if (steep)
+    {
+      blendPixel(iy, x, 255-coverage);
+      blendPixel(iy+1, x, coverage);
+    } else
+    {
+      blendPixel(x, iy, 255-coverage);
+      blendPixel(x, iy+1, coverage);
+    }
+    y += gradient;
+  }
+}
+
+/*! \internal
+
+  Blends the pen color with the given \a coverage (0 to 255) onto the pixel at \a x, \a y (device
+  pixels) with source-over composition. Pixels outside the clip rect are ignored.
+*/
+inline void QCPLineRasterizer::blendPixel(int x, int y, int coverage)
+{
+  if (coverage <= 0 || x < mClip.left() || x > mClip.right() || y < mClip.top() || y > mClip.bottom())
+    return;
+  // multiplies each 8 bit channel of a premultiplied ARGB value by alpha/255 (two channels at a time):
+  struct Multiply
+  {
+    static quint32 byteMul(quint32 value, quint32 alpha)
+    {
+      quint32 rb = (value & 0xff00ff)*alpha;
+      rb = ((rb + ((rb >> 8) & 0xff00ff) + 0x800080) >> 8) & 0xff00ff;
+      quint32 ag = ((value >> 8) & 0xff00ff)*alpha;
+      ag = (ag + ((ag >> 8) & 0xff00ff) + 0x800080) & 0xff00ff00;
+      return ag | rb;
+    }
+  };
+  quint32 *pixel = reinterpret_cast<quint32*>(mBits + y*mBytesPerLine) + x;
+  const quint32 source = coverage >= 255 ? mColor : Multiply::byteMul(mColor, quint32(coverage));
+  const quint32 sourceAlpha = qAlpha(source);
+  if (sourceAlpha == 255)
+    *pixel = source;
+  else
+    *pixel = source + Multiply::byteMul(*pixel, 255-sourceAlpha);
+}
+/* end of 'src/linerasterizer.cpp' */
+
+
 /* including file 'src/paintbuffer.cpp'     */
 /* modified 2021-03-29T02:30:44, size 18915 */
 
@@ -720,6 +1011,155 @@ void QCPPaintBufferPixmap::reallocateBuffer()
 }
 
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPPaintBufferImage
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPPaintBufferImage
+  \brief A paint buffer based on QImage, using software raster rendering
+
+  This paint buffer uses software rendering like \ref QCPPaintBufferPixmap, but keeps its contents
+  in a QImage. Unlike QPixmap, a QImage may be painted on outside the GUI thread, so this paint
+  buffer is used if \ref QCustomPlot::setParallelRasterization is enabled, to let independent
+  paint buffers (and disjoint regions within one buffer, see \ref subImage) be rasterized
+  concurrently by \ref QCPRasterJob instances.
+*/
+
+/*!
+  Creates an image paint buffer instance with the specified \a size and \a devicePixelRatio, if
+  applicable.
+*/
+QCPPaintBufferImage::QCPPaintBufferImage(const QSize &size, double devicePixelRatio) :
+  QCPAbstractPaintBuffer(size, devicePixelRatio)
+{
+  QCPPaintBufferImage::reallocateBuffer();
+}
+
+QCPPaintBufferImage::~QCPPaintBufferImage()
+{
+}
+
+/* inherits documentation from base class */
+QCPPainter *QCPPaintBufferImage::startPainting()
+{
+  QCPPainter *result = new QCPPainter(&mBuffer);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+  result->setRenderHint(QPainter::HighQualityAntialiasing);
+#endif
+  return result;
+}
+
+/* inherits documentation from base class */
+void QCPPaintBufferImage::draw(QCPPainter *painter) const
+{
+  if (painter && painter->isActive())
+    painter->drawImage(0, 0, mBuffer);
+  else
+    qDebug() << Q_FUNC_INFO << "invalid or inactive painter passed";
+}
+
+/* inherits documentation from base class */
+void QCPPaintBufferImage::clear(const QColor &color)
+{
+  mBuffer.fill(color);
+}
+
+/*!
+  Returns a QImage which shares its memory with the region \a deviceRect (given in device pixels)
+  of this buffer. Painting on the returned image thus directly modifies this buffer.
+
+  Multiple sub images with disjoint regions may be painted on concurrently from different threads.
+  Sub images must be created in the thread that owns the buffer, and they become invalid as soon as
+  the buffer is reallocated (\ref setSize, \ref setDevicePixelRatio).
+*/
+QImage QCPPaintBufferImage::subImage(const QRect &deviceRect)
+{
+  const QRect rect = deviceRect & mBuffer.rect();
+  if (rect.isEmpty())
+    return QImage();
+  uchar *bits = mBuffer.bits() + rect.top()*mBuffer.bytesPerLine() + rect.left()*(mBuffer.depth()/8);
+  QImage result(bits, rect.width(), rect.height(), mBuffer.bytesPerLine(), mBuffer.format());
+#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
+  result.setDevicePixelRatio(mDevicePixelRatio);
+#endif
+  return result;
+}
+
+/* inherits documentation from base class */
+void QCPPaintBufferImage::reallocateBuffer()
+{
+  setInvalidated();
+  if (!qFuzzyCompare(1.0, mDevicePixelRatio))
+  {
+#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
+    mBuffer = QImage(mSize*mDevicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    mBuffer.setDevicePixelRatio(mDevicePixelRatio);
+#else
+    qDebug() << Q_FUNC_INFO << "Device pixel ratios not supported for Qt versions before 5.4";
+    mDevicePixelRatio = 1.0;
+    mBuffer = QImage(mSize, QImage::Format_ARGB32_Premultiplied);
+#endif
+  } else
+  {
+    mBuffer = QImage(mSize, QImage::Format_ARGB32_Premultiplied);
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPRasterJob
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPRasterJob
+  \internal
+  \brief Draws a list of layerables onto a QImage, to be run on a thread pool
+
+  Instances are created by \ref QCustomPlot::replot when \ref QCustomPlot::setParallelRasterization
+  is enabled, one per independent paint buffer or disjoint buffer region. The target image usually
+  is a \ref QCPPaintBufferImage::subImage, whose top left corner corresponds to \a offset in plot
+  coordinates.
+
+  The job draws with the \ref QCPPainter::pmNoCaching mode, because the label caches of the axes
+  consist of QPixmaps, which must not be created outside the GUI thread.
+*/
+
+/*!
+  Creates a job that draws the \a layerables (in the given order) onto \a target. \a offset is the
+  plot coordinate (in logical pixels) of the top left corner of \a target.
+*/
+QCPRasterJob::QCPRasterJob(const QImage &target, const QPoint &offset, const QList<QCPLayerable*> &layerables) :
+  mTarget(target),
+  mOffset(offset),
+  mLayerables(layerables)
+{
+}
+
+/* inherits documentation from base class */
+void QCPRasterJob::run()
+{
+  QCPPainter painter(&mTarget);
+  if (!painter.isActive())
+  {
+    qDebug() << Q_FUNC_INFO << "failed to activate painter on target image";
+    return;
+  }
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+  painter.setRenderHint(QPainter::HighQualityAntialiasing);
+#endif
+  painter.setMode(QCPPainter::pmNoCaching);
+  painter.translate(-mOffset);
+  foreach (QCPLayerable *child, mLayerables) // same steps as QCPLayer::draw
+  {
+    QCPProfileScope layerableScope(child->parentPlot()->profiler(), child);
+    painter.save();
+    painter.setClipRect(child->clipRect().translated(0, -1));
+    child->applyDefaultAntialiasingHint(&painter);
+    child->draw(&painter);
+    painter.restore();
+  }
+}
+
+
 #ifdef QCP_OPENGL_PBUFFER
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////// QCPPaintBufferGlPbuffer
@@ -975,6 +1415,339 @@ void QCPPaintBufferGlFbo::reallocateBuffer()
 /* end of 'src/paintbuffer.cpp' */
 
 
+/* including file 'src/profiler.cpp'       */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPProfiler
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPProfiler
+  \brief Records where the time of replots is spent
+  
+  When profiling is enabled with \ref QCustomPlot::setProfilingEnabled, the plot records the time
+  spans of the stages of each replot: the whole replot (or frame of the render thread, see \ref
+  QCustomPlot::setAsyncRendering), the layout update, the paint buffer setup, the drawing of each
+  layer into its paint buffer, the \ref QCPLayerable::draw call of each layerable, and the final
+  paint of the buffers onto the widget. Layerables drawn concurrently (see \ref
+  QCustomPlot::setParallelRasterization) are recorded with the thread they were drawn in.
+  
+  The recorded spans can be retrieved with \ref events, or exported in the Chrome trace event
+  format with \ref saveChromeTrace, to be inspected in chrome://tracing or Perfetto. To keep the
+  memory bounded, only the most recent spans are kept (see \ref setMaximumEvents).
+  
+  For live numbers, \ref setOverlayVisible shows the most expensive spans of the last frame on top
+  of the plot.
+  
+  Without profiling enabled, \ref QCustomPlot::profiler returns \c nullptr and the instrumentation
+  reduces to a pointer check per stage and layerable.
+  
+  \see QCPProfileScope
+*/
+
+/*!
+  Creates a profiler. Usually you don't create it yourself, but enable profiling with \ref
+  QCustomPlot::setProfilingEnabled and retrieve it with \ref QCustomPlot::profiler.
+*/
+QCPProfiler::QCPProfiler() :
+  mMaximumEvents(100000),
+  mOverlayVisible(false),
+  mFrameStart(-1)
+{
+  mClock.start();
+}
+
+/*!
+  Sets the maximum number of recorded spans. If more spans are recorded, the oldest ones are
+  discarded.
+*/
+void QCPProfiler::setMaximumEvents(int count)
+{
+  QMutexLocker locker(&mMutex);
+  mMaximumEvents = qMax(1, count);
+  while (mEvents.size() > mMaximumEvents)
+    mEvents.removeFirst();
+}
+
+/*!
+  Sets whether the parent plot draws an overlay with the total time and the most expensive spans of
+  the last frame in its top left corner (see \ref drawOverlay). The overlay is painted directly on
+  the widget and doesn't influence the measured replot time.
+*/
+void QCPProfiler::setOverlayVisible(bool visible)
+{
+  mOverlayVisible = visible;
+}
+
+/*!
+  Records a span of \a category with the given \a name, which started at \a start and ended at \a
+  end (both obtained with \ref now). This method may be called from any thread.
+  
+  Spans recorded while no frame is open (see \ref beginFrame), like the final paint of the widget
+  which follows the replot, are attributed to the last completed frame (\ref lastFrame). If that
+  frame already holds a span of the same category and name (e.g. after repeated paint events), it
+  is replaced.
+  
+  Usually spans are recorded by \ref QCPProfileScope instances.
+*/
+void QCPProfiler::record(const char *category, const QString &name, qint64 start, qint64 end)
+{
+  QMutexLocker locker(&mMutex);
+  Event event;
+  event.name = name;
+  event.category = QLatin1String(category);
+  event.start = start;
+  event.duration = end-start;
+  const Qt::HANDLE threadHandle = QThread::currentThreadId();
+  QHash<Qt::HANDLE, int>::const_iterator it = mThreadIds.constFind(threadHandle);
+  if (it == mThreadIds.constEnd())
+    it = mThreadIds.insert(threadHandle, mThreadIds.size());
+  event.thread = it.value();
+  mEvents.append(event);
+  if (mEvents.size() > mMaximumEvents)
+    mEvents.removeFirst();
+  
+  if (mFrameStart < 0 && !mLastFrame.isEmpty())
+  {
+    for (int i=0; i<mLastFrame.size(); ++i)
+    {
+      if (mLastFrame.at(i).category == event.category && mLastFrame.at(i).name == event.name)
+      {
+        mLastFrame.removeAt(i);
+        break;
+      }
+    }
+    mLastFrame.append(event);
+  }
+}
+
+/*! \internal
+  
+  Marks the start of a frame, i.e. a replot or a frame of the render thread. The spans recorded
+  until the matching \ref endFrame form the frame returned by \ref lastFrame.
+*/
+void QCPProfiler::beginFrame()
+{
+  QMutexLocker locker(&mMutex);
+  mFrameStart = now();
+}
+
+/*! \internal
+  
+  Marks the end of the frame started with \ref beginFrame.
+*/
+void QCPProfiler::endFrame()
+{
+  QMutexLocker locker(&mMutex);
+  if (mFrameStart < 0)
+    return;
+  QList<Event> frame;
+  for (int i=mEvents.size()-1; i>=0 && mEvents.at(i).start >= mFrameStart; --i)
+    frame.prepend(mEvents.at(i));
+  mLastFrame = frame;
+  mFrameStart = -1;
+}
+
+/*!
+  Returns all recorded spans in the order they ended. Spans of nested stages end before the
+  enclosing ones.
+*/
+QList<QCPProfiler::Event> QCPProfiler::events() const
+{
+  QMutexLocker locker(&mMutex);
+  return mEvents;
+}
+
+/*!
+  Returns the spans of the last completed frame, including the span of the frame itself.
+*/
+QList<QCPProfiler::Event> QCPProfiler::lastFrame() const
+{
+  QMutexLocker locker(&mMutex);
+  return mLastFrame;
+}
+
+/*!
+  Discards all recorded spans.
+*/
+void QCPProfiler::clear()
+{
+  QMutexLocker locker(&mMutex);
+  mEvents.clear();
+  mLastFrame.clear();
+}
+
+/*!
+  Returns the recorded spans as a JSON document in the Chrome trace event format, as complete
+  events ("ph":"X") with their times in microseconds.
+  
+  \see saveChromeTrace
+*/
+QByteArray QCPProfiler::toChromeTrace() const
+{
+  const QList<Event> recorded = events();
+  QByteArray result;
+  result.reserve(recorded.size()*96+64);
+  result += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  for (int i=0; i<recorded.size(); ++i)
+  {
+    const Event &event = recorded.at(i);
+    QString name = event.name;
+    name.replace(QLatin1Char('\\'), QLatin1String("\\\\")).replace(QLatin1Char('"'), QLatin1String("\\\""));
+    for (int k=0; k<name.size(); ++k) // remaining control characters aren't allowed in JSON strings
+    {
+      if (name.at(k).unicode() < 0x20)
+        name[k] = QLatin1Char(' ');
+    }
+    if (i > 0)
+      result += ',';
+    result += "\n{\"name\":\"" + name.toUtf8() + "\",\"cat\":\"" + event.category.toUtf8() + "\",\"ph\":\"X\"";
+    result += ",\"ts\":" + QByteArray::number(event.start*1e-3, 'f', 3);
+    result += ",\"dur\":" + QByteArray::number(event.duration*1e-3, 'f', 3);
+    result += ",\"pid\":1,\"tid\":" + QByteArray::number(event.thread) + '}';
+  }
+  result += "\n]}\n";
+  return result;
+}
+
+/*!
+  Writes the recorded spans to the file \a fileName in the Chrome trace event format (see \ref
+  toChromeTrace). Returns true on success.
+*/
+bool QCPProfiler::saveChromeTrace(const QString &fileName) const
+{
+  QFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+  {
+    qDebug() << Q_FUNC_INFO << "Couldn't open file for writing:" << fileName;
+    return false;
+  }
+  const QByteArray trace = toChromeTrace();
+  return file.write(trace) == trace.size();
+}
+
+/*!
+  Draws the total duration of the last frame and its most expensive spans (excluding the frame
+  span itself) as text with \a painter into the top left corner of \a rect, on a half transparent
+  background.
+  
+  This is called by the parent plot when the overlay is enabled with \ref setOverlayVisible.
+*/
+void QCPProfiler::drawOverlay(QPainter *painter, const QRect &rect) const
+{
+  QList<Event> frame = lastFrame();
+  if (frame.isEmpty())
+    return;
+  
+  QStringList lines;
+  QList<Event> spans;
+  foreach (const Event &event, frame)
+  {
+    if (event.category == QLatin1String("replot") || event.category == QLatin1String("frame"))
+      lines.prepend(QString(QLatin1String("%1: %2 ms")).arg(event.category).arg(event.duration*1e-6, 0, 'f', 2));
+    else
+      spans.append(event);
+  }
+  std::sort(spans.begin(), spans.end(), [](const Event &a, const Event &b) { return a.duration > b.duration; });
+  const int maxLines = 10;
+  for (int i=0; i<spans.size() && i<maxLines; ++i)
+    lines.append(QString(QLatin1String("%1 ms  %2 %3")).arg(spans.at(i).duration*1e-6, 6, 'f', 2).arg(spans.at(i).category, spans.at(i).name));
+  
+  painter->save();
+  QFont font = painter->font();
+  font.setStyleHint(QFont::Monospace);
+  font.setFamily(QLatin1String("Monospace"));
+  painter->setFont(font);
+  const QString text = lines.join(QLatin1String("\n"));
+  QRect textRect = painter->fontMetrics().boundingRect(rect.adjusted(4, 4, -4, -4), Qt::AlignLeft | Qt::AlignTop, text);
+  painter->fillRect(textRect.adjusted(-4, -4, 4, 4), QColor(0, 0, 0, 160));
+  painter->setPen(Qt::white);
+  painter->drawText(textRect, Qt::AlignLeft | Qt::AlignTop, text);
+  painter->restore();
+}
+
+/*!
+  Returns a short description of \a layerable for the recorded spans: its class name, followed by
+  its name if it's a plottable or layer, or its axis type if it's an axis, and its address to tell
+  apart layerables of the same kind.
+*/
+QString QCPProfiler::layerableName(const QCPLayerable *layerable)
+{
+  if (!layerable)
+    return QString();
+  QString result = QLatin1String(layerable->metaObject()->className());
+  if (const QCPAbstractPlottable *plottable = qobject_cast<const QCPAbstractPlottable*>(layerable))
+  {
+    if (!plottable->name().isEmpty())
+      result += QLatin1String(" \"") + plottable->name() + QLatin1Char('"');
+  } else if (const QCPAxis *axis = qobject_cast<const QCPAxis*>(layerable))
+  {
+    switch (axis->axisType())
+    {
+      case QCPAxis::atLeft: result += QLatin1String(" left"); break;
+      case QCPAxis::atRight: result += QLatin1String(" right"); break;
+      case QCPAxis::atTop: result += QLatin1String(" top"); break;
+      case QCPAxis::atBottom: result += QLatin1String(" bottom"); break;
+    }
+  } else if (!layerable->objectName().isEmpty())
+    result += QLatin1String(" \"") + layerable->objectName() + QLatin1Char('"');
+  result += QString(QLatin1String(" @0x%1")).arg(quintptr(layerable), 0, 16);
+  return result;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPProfileScope
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPProfileScope
+  \brief Records the lifetime of the scope it's created in as a span of a QCPProfiler
+  
+  If the passed profiler is \c nullptr (i.e. profiling is disabled), the scope does nothing.
+  \code
+  QCPProfileScope scope(mParentPlot->profiler(), "layout", QLatin1String("updateLayout"));
+  \endcode
+*/
+
+/*!
+  Starts a span of \a category with the given \a name in \a profiler, which is recorded when
+  this scope object is destroyed.
+*/
+QCPProfileScope::QCPProfileScope(QCPProfiler *profiler, const char *category, const QString &name) :
+  mProfiler(profiler),
+  mCategory(category),
+  mStart(0)
+{
+  if (mProfiler)
+  {
+    mName = name;
+    mStart = mProfiler->now();
+  }
+}
+
+/*!
+  Starts a span of the category "layerable", named after \a layerable (see \ref
+  QCPProfiler::layerableName). The name is only built if \a profiler isn't \c nullptr.
+*/
+QCPProfileScope::QCPProfileScope(QCPProfiler *profiler, const QCPLayerable *layerable) :
+  mProfiler(profiler),
+  mCategory("layerable"),
+  mStart(0)
+{
+  if (mProfiler)
+  {
+    mName = QCPProfiler::layerableName(layerable);
+    mStart = mProfiler->now();
+  }
+}
+
+QCPProfileScope::~QCPProfileScope()
+{
+  if (mProfiler)
+    mProfiler->record(mCategory, mName, mStart, mProfiler->now());
+}
+/* end of 'src/profiler.cpp' */
+
+
 /* including file 'src/layer.cpp'           */
 /* modified 2021-03-29T02:30:44, size 37615 */
 
@@ -1142,10 +1915,12 @@ void QCPLayer::setMode(QCPLayer::LayerMode mode)
 */
 void QCPLayer::draw(QCPPainter *painter)
 {
+  QCPProfiler *profiler = mParentPlot->profiler();
   foreach (QCPLayerable *child, mChildren)
   {
     if (child->realVisibility())
     {
+      QCPProfileScope layerableScope(profiler, child);
       painter->save();
       painter->setClipRect(child->clipRect().translated(0, -1));
       child->applyDefaultAntialiasingHint(painter);
@@ -1165,6 +1940,7 @@ void QCPLayer::draw(QCPPainter *painter)
 */
 void QCPLayer::drawToPaintBuffer()
 {
+  QCPProfileScope layerScope(mParentPlot->profiler(), "layer", mName);
   if (QSharedPointer<QCPAbstractPaintBuffer> pb = mPaintBuffer.toStrongRef())
   {
     if (QCPPainter *painter = pb->startPainting())
@@ -1181,6 +1957,24 @@ void QCPLayer::drawToPaintBuffer()
     qDebug() << Q_FUNC_INFO << "no valid paint buffer associated with this layer";
 }
 
+/*! \internal
+
+  Returns whether this layer holds layerables whose appearance typically changes without any change
+  of the axis ranges, i.e. plottables (new data) and items (e.g. tracers following the data).
+
+  When the plotting hint \ref QCP::phSkipStaticLayers is set, \ref QCustomPlot::replot only
+  redraws the paint buffers of such layers, as long as the viewport and axis ranges are unchanged.
+*/
+bool QCPLayer::hasDynamicContent() const
+{
+  foreach (QCPLayerable *child, mChildren)
+  {
+    if (qobject_cast<QCPAbstractPlottable*>(child) || qobject_cast<QCPAbstractItem*>(child))
+      return true;
+  }
+  return false;
+}
+
 /*!
   If the layer mode (\ref setMode) is set to \ref lmBuffered, this method allows replotting only
   the layerables on this specific layer, without the need to replot all other layers (as a call to
@@ -1190,14 +1984,15 @@ void QCPLayer::drawToPaintBuffer()
   or any layerable-layer-association has changed since the last full replot and any other paint
   buffers were thus invalidated.
 
-  If the layer mode is \ref lmLogical however, this method simply calls \ref QCustomPlot::replot on
-  the parent QCustomPlot instance.
+  If the layer mode is \ref lmLogical however, or if the parent plot uses asynchronous rendering
+  (\ref QCustomPlot::setAsyncRendering), this method simply calls \ref QCustomPlot::replot on the
+  parent QCustomPlot instance.
 
   \see draw
 */
 void QCPLayer::replot()
 {
-  if (mMode == lmBuffered && !mParentPlot->hasInvalidatedPaintBuffers())
+  if (mMode == lmBuffered && !mParentPlot->renderThread() && !mParentPlot->hasInvalidatedPaintBuffers())
   {
     if (QSharedPointer<QCPAbstractPaintBuffer> pb = mPaintBuffer.toStrongRef())
     {
@@ -6119,7 +6914,13 @@ void QCPLabelPainterPrivate::analyzeFontMetrics()
 QCPAxisTicker::QCPAxisTicker() :
   mTickStepStrategy(tssReadability),
   mTickCount(5),
-  mTickOrigin(0)
+  mTickOrigin(0),
+  mCacheValid(false),
+  mCachedPrecision(0),
+  mCachedTickStep(0),
+  mCachedSubTicksValid(false),
+  mCachedTickLabelsValid(false),
+  mReuseCachedLabels(false)
 {
 }
 
@@ -6134,6 +6935,7 @@ QCPAxisTicker::~QCPAxisTicker()
 */
 void QCPAxisTicker::setTickStepStrategy(QCPAxisTicker::TickStepStrategy strategy)
 {
+  clearCache();
   mTickStepStrategy = strategy;
 }
 
@@ -6147,6 +6949,7 @@ void QCPAxisTicker::setTickStepStrategy(QCPAxisTicker::TickStepStrategy strategy
 */
 void QCPAxisTicker::setTickCount(int count)
 {
+  clearCache();
   if (count > 0)
     mTickCount = count;
   else
@@ -6163,6 +6966,7 @@ void QCPAxisTicker::setTickCount(int count)
 */
 void QCPAxisTicker::setTickOrigin(double origin)
 {
+  clearCache();
   mTickOrigin = origin;
 }
 
@@ -6178,9 +6982,28 @@ void QCPAxisTicker::setTickOrigin(double origin)
   The output parameters \a subTicks and \a tickLabels are optional (set them to \c nullptr if not
   needed) and are respectively filled with sub tick coordinates, and tick label strings belonging
   to \a ticks by index.
+
+  The result of the last generation is cached. If it is requested again with the same parameters,
+  e.g. because the plot is replotted with unchanged axis range, the cached vectors are returned
+  without calling any of the virtual generation methods. If only the range has changed but not the
+  tick step (e.g. while a time axis is scrolling), the labels of ticks that were already present in
+  the previous generation are reused by \ref createLabelVector, so only the ticks that scrolled into
+  view need new labels. Subclasses which introduce parameters that influence the ticks or labels
+  must call \ref clearCache whenever these parameters change.
 */
 void QCPAxisTicker::generate(const QCPRange &range, const QLocale &locale, QChar formatChar, int precision, QVector<double> &ticks, QVector<double> *subTicks, QVector<QString> *tickLabels)
 {
+  const bool sameLabelParameters = mCacheValid && locale == mCachedLocale && formatChar == mCachedFormatChar && precision == mCachedPrecision;
+  if (sameLabelParameters && range == mCachedRange && (!subTicks || mCachedSubTicksValid) && (!tickLabels || mCachedTickLabelsValid))
+  {
+    ticks = mCachedTicks;
+    if (subTicks)
+      *subTicks = mCachedSubTicks;
+    if (tickLabels)
+      *tickLabels = mCachedTickLabels;
+    return;
+  }
+  
   // generate (major) ticks:
   double tickStep = getTickStep(range);
   ticks = createTickVector(tickStep, range);
@@ -6201,7 +7024,40 @@ void QCPAxisTicker::generate(const QCPRange &range, const QLocale &locale, QChar
   trimTicks(range, ticks, false);
   // generate labels for visible ticks if requested:
   if (tickLabels)
+  {
+    mReuseCachedLabels = sameLabelParameters && mCachedTickLabelsValid && tickStep == mCachedTickStep;
     *tickLabels = createLabelVector(ticks, locale, formatChar, precision);
+    mReuseCachedLabels = false;
+  }
+  
+  // remember result for the next generation:
+  mCacheValid = true;
+  mCachedRange = range;
+  mCachedLocale = locale;
+  mCachedFormatChar = formatChar;
+  mCachedPrecision = precision;
+  mCachedTickStep = tickStep;
+  mCachedTicks = ticks;
+  mCachedSubTicksValid = subTicks;
+  mCachedSubTicks = subTicks ? *subTicks : QVector<double>();
+  mCachedTickLabelsValid = tickLabels;
+  mCachedTickLabels = tickLabels ? *tickLabels : QVector<QString>();
+}
+
+/*!
+  Discards the cached result of the last \ref generate call, so the next call generates ticks and
+  labels from scratch.
+
+  All setters of QCPAxisTicker and its subclasses call this method. If you subclass QCPAxisTicker
+  and introduce own parameters that influence the generated ticks or labels, call it whenever these
+  parameters change.
+*/
+void QCPAxisTicker::clearCache()
+{
+  mCacheValid = false;
+  mCachedTicks.clear();
+  mCachedSubTicks.clear();
+  mCachedTickLabels.clear();
 }
 
 /*! \internal
@@ -6362,8 +7218,23 @@ QVector<QString> QCPAxisTicker::createLabelVector(const QVector<double> &ticks,
 {
   QVector<QString> result;
   result.reserve(ticks.size());
-  foreach (double tickCoord, ticks)
-    result.append(getTickLabel(tickCoord, locale, formatChar, precision));
+  if (mReuseCachedLabels) // same label parameters and tick step as in the previous generation, so only ticks that weren't there before need a new label
+  {
+    int cacheIndex = 0;
+    foreach (double tickCoord, ticks)
+    {
+      while (cacheIndex < mCachedTicks.size() && mCachedTicks.at(cacheIndex) < tickCoord)
+        ++cacheIndex;
+      if (cacheIndex < mCachedTicks.size() && mCachedTicks.at(cacheIndex) == tickCoord)
+        result.append(mCachedTickLabels.at(cacheIndex));
+      else
+        result.append(getTickLabel(tickCoord, locale, formatChar, precision));
+    }
+  } else
+  {
+    foreach (double tickCoord, ticks)
+      result.append(getTickLabel(tickCoord, locale, formatChar, precision));
+  }
   return result;
 }
 
@@ -6523,7 +7394,12 @@ double QCPAxisTicker::cleanMantissa(double input) const
 QCPAxisTickerDateTime::QCPAxisTickerDateTime() :
   mDateTimeFormat(QLatin1String("hh:mm:ss\ndd.MM.yy")),
   mDateTimeSpec(Qt::LocalTime),
-  mDateStrategy(dsNone)
+  mDateStrategy(dsNone),
+  mFastFormatState(ffsUnchecked),
+  mFormatHasAmPm(false),
+  mOffsetBucket(0),
+  mOffsetSeconds(0),
+  mOffsetValid(false)
 {
   setTickCount(4);
 }
@@ -6567,6 +7443,8 @@ QCPAxisTickerDateTime::QCPAxisTickerDateTime() :
 */
 void QCPAxisTickerDateTime::setDateTimeFormat(const QString &format)
 {
+  clearCache();
+  resetFastFormat();
   mDateTimeFormat = format;
 }
 
@@ -6585,6 +7463,8 @@ void QCPAxisTickerDateTime::setDateTimeFormat(const QString &format)
 */
 void QCPAxisTickerDateTime::setDateTimeSpec(Qt::TimeSpec spec)
 {
+  clearCache();
+  resetFastFormat();
   mDateTimeSpec = spec;
 }
 
@@ -6597,6 +7477,8 @@ void QCPAxisTickerDateTime::setDateTimeSpec(Qt::TimeSpec spec)
 */
 void QCPAxisTickerDateTime::setTimeZone(const QTimeZone &zone)
 {
+  clearCache();
+  resetFastFormat();
   mTimeZone = zone;
   mDateTimeSpec = Qt::TimeZone;
 }
@@ -6708,6 +7590,10 @@ int QCPAxisTickerDateTime::getSubTickCount(double tickStep)
   Generates a date/time tick label for tick coordinate \a tick, based on the currently set format
   (\ref setDateTimeFormat), time spec (\ref setDateTimeSpec), and possibly time zone (\ref
   setTimeZone).
+
+  If the format allows it (see \ref prepareFastFormat), the label is created by \ref fastTickLabel
+  which avoids creating and formatting a QDateTime for every tick. Otherwise, the label is formatted
+  with QLocale::toString.
   
   \seebaseclassmethod
 */
@@ -6715,14 +7601,9 @@ QString QCPAxisTickerDateTime::getTickLabel(double tick, const QLocale &locale,
 {
   Q_UNUSED(precision)
   Q_UNUSED(formatChar)
-# if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
-  if (mDateTimeSpec == Qt::TimeZone)
-    return locale.toString(keyToDateTime(tick).toTimeZone(mTimeZone), mDateTimeFormat);
-  else
-    return locale.toString(keyToDateTime(tick).toTimeSpec(mDateTimeSpec), mDateTimeFormat);
-# else
-  return locale.toString(keyToDateTime(tick).toTimeSpec(mDateTimeSpec), mDateTimeFormat);
-# endif
+  if (prepareFastFormat(locale))
+    return fastTickLabel(tick, locale);
+  return slowTickLabel(tick, locale);
 }
 
 /*! \internal
@@ -6827,6 +7708,276 @@ double QCPAxisTickerDateTime::dateTimeToKey(const QDate &date, Qt::TimeSpec time
   return date.startOfDay(timeSpec).toMSecsSinceEpoch()/1000.0;
 # endif
 }
+/*! \internal
+
+  Discards the state of the fast label formatter, so it is set up again for the next label. Called
+  whenever a parameter that influences the labels changes.
+*/
+void QCPAxisTickerDateTime::resetFastFormat()
+{
+  mFastFormatState = ffsUnchecked;
+  mDayFormat.clear();
+  mTimeTokens.clear();
+  mDayLabelCache.clear();
+  mOffsetValid = false;
+}
+
+/*! \internal
+
+  Prepares the fast label formatter for the current date time format and the passed \a locale, and
+  returns whether it can be used.
+
+  The format is split into the time fields (hours, minutes, seconds and milliseconds), which are
+  later filled in by \ref fastTickLabel with integer arithmetic, and the remaining date format
+  (\c mDayFormat), in which each time field is replaced by a placeholder character from the Unicode
+  private use area. The placeholders are inserted unquoted: they aren't format letters, so QLocale
+  copies them literally, and quoting them would turn two adjacent quote characters into an escaped
+  apostrophe. The date format is still formatted by QLocale, but only once per day (or half day, if
+  the format contains an AM/PM marker), so all date related format semantics (localized names, year
+  digits, quoting) stay exactly as with QLocale::toString.
+
+  Finally, the fast labels of a few sample times are compared with the labels of \ref
+  slowTickLabel. If any of them differ, the fast formatter is not used.
+
+  Formats which contain fields whose semantics vary between Qt versions or depend on more than the
+  date and time of day (the time zone \c t and the short millisecond forms \c z and \c zz), and
+  locales with non-latin digits fall back to QLocale::toString. So do Qt versions before 5.2, which
+  lack the API to determine UTC offsets efficiently.
+*/
+bool QCPAxisTickerDateTime::prepareFastFormat(const QLocale &locale)
+{
+  if (mFastFormatState != ffsUnchecked && locale == mFastFormatLocale)
+    return mFastFormatState == ffsValid;
+  
+  resetFastFormat();
+  mFastFormatLocale = locale;
+  mFastFormatState = ffsInvalid;
+  mFormatHasAmPm = false;
+# if QT_VERSION < QT_VERSION_CHECK(5, 2, 0)
+  return false;
+# endif
+  if (QString(locale.zeroDigit()) != QLatin1String("0"))
+    return false;
+  
+  const QString &format = mDateTimeFormat;
+  const int formatSize = format.size();
+  const ushort placeholderBase = 0xE000; // private use area, placeholder for the n-th time field is placeholderBase+n
+  QString dayFormat;
+  QVector<TimeToken> timeTokens;
+  int i = 0;
+  while (i < formatSize)
+  {
+    const QChar c = format.at(i);
+    if (c.unicode() >= placeholderBase && c.unicode() < placeholderBase+0x1000)
+      return false;
+    if (c == QLatin1Char('\''))
+    {
+      // copy quoted text (and escaped quotes '') unchanged:
+      int end = i+1;
+      if (end < formatSize && format.at(end) == QLatin1Char('\'')) // escaped quote
+        ++end;
+      else
+      {
+        while (end < formatSize)
+        {
+          if (format.at(end) == QLatin1Char('\''))
+          {
+            if (end+1 < formatSize && format.at(end+1) == QLatin1Char('\''))
+              ++end;
+            else
+              break;
+          }
+          ++end;
+        }
+      }
+      end = qMin(end+1, formatSize);
+      dayFormat += format.mid(i, end-i);
+      i = end;
+      continue;
+    }
+    int repeat = 1;
+    while (i+repeat < formatSize && format.at(i+repeat) == c)
+      ++repeat;
+    TimeToken token;
+    int tokenSize = 0;
+    switch (c.unicode())
+    {
+      case 'h': token.field = tfHour12; tokenSize = qMin(repeat, 2); break; // 12 hour display is resolved below once the whole format is known
+      case 'H': token.field = tfHour; tokenSize = qMin(repeat, 2); break;
+      case 'm': token.field = tfMinute; tokenSize = qMin(repeat, 2); break;
+      case 's': token.field = tfSecond; tokenSize = qMin(repeat, 2); break;
+      case 'z':
+      {
+        if (repeat < 3)
+          return false;
+        token.field = tfMillisecond;
+        tokenSize = 3;
+        break;
+      }
+      case 't': return false;
+      case 'a':
+      case 'A': mFormatHasAmPm = true; break;
+    }
+    if (tokenSize > 0)
+    {
+      token.width = tokenSize;
+      dayFormat += QChar(ushort(placeholderBase+timeTokens.size()));
+      timeTokens.append(token);
+      i += tokenSize;
+    } else
+    {
+      dayFormat += c;
+      ++i;
+    }
+  }
+  // lower case h shows hours from 1 to 12 only if format contains AM/PM marker:
+  if (!mFormatHasAmPm)
+  {
+    for (int k=0; k<timeTokens.size(); ++k)
+    {
+      if (timeTokens.at(k).field == tfHour12)
+        timeTokens[k].field = tfHour;
+    }
+  }
+  
+  mDayFormat = dayFormat;
+  mTimeTokens = timeTokens;
+  
+  // make sure the fast labels are identical to the ones of QLocale::toString, for sample times with
+  // one and two digit fields, both day halves and a negative key:
+  const double sampleKeys[] = {0.0, 951827696.789, 1234567890.5, 1700000000.123, 1262307723.004, -3600.25};
+  for (size_t k=0; k<sizeof(sampleKeys)/sizeof(sampleKeys[0]); ++k)
+  {
+    if (fastTickLabel(sampleKeys[k], locale) != slowTickLabel(sampleKeys[k], locale))
+    {
+      resetFastFormat();
+      mFastFormatLocale = locale;
+      mFastFormatState = ffsInvalid;
+      return false;
+    }
+  }
+  mFastFormatState = ffsValid;
+  return true;
+}
+
+/*! \internal
+
+  Formats the tick label for \a tick with QLocale::toString, via a QDateTime in the configured time
+  spec (\ref setDateTimeSpec) or time zone (\ref setTimeZone). This is the reference for the fast
+  label formatter, see \ref prepareFastFormat.
+*/
+QString QCPAxisTickerDateTime::slowTickLabel(double tick, const QLocale &locale) const
+{
+# if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+  if (mDateTimeSpec == Qt::TimeZone)
+    return locale.toString(keyToDateTime(tick).toTimeZone(mTimeZone), mDateTimeFormat);
+  else
+    return locale.toString(keyToDateTime(tick).toTimeSpec(mDateTimeSpec), mDateTimeFormat);
+# else
+  return locale.toString(keyToDateTime(tick).toTimeSpec(mDateTimeSpec), mDateTimeFormat);
+# endif
+}
+
+/*! \internal
+
+  Returns the offset in seconds of the configured time spec (\ref setDateTimeSpec) and time zone
+  (\ref setTimeZone) from UTC, at the time \a msecs since Epoch.
+
+  Offsets only change at transitions (e.g. daylight saving time), which happen at full quarter
+  hours. So the offset is determined once per quarter hour and reused for the following ticks in
+  that quarter hour.
+*/
+int QCPAxisTickerDateTime::utcOffset(qint64 msecs)
+{
+  if (mDateTimeSpec == Qt::UTC || mDateTimeSpec == Qt::OffsetFromUTC)
+    return 0;
+  const qint64 bucketMSecs = 15*60*1000;
+  const qint64 bucket = msecs >= 0 ? msecs/bucketMSecs : -((-msecs+bucketMSecs-1)/bucketMSecs);
+  if (!mOffsetValid || bucket != mOffsetBucket)
+  {
+# if QT_VERSION >= QT_VERSION_CHECK(5, 2, 0)
+    const QDateTime bucketStart = QDateTime::fromMSecsSinceEpoch(bucket*bucketMSecs, Qt::UTC);
+    if (mDateTimeSpec == Qt::TimeZone)
+      mOffsetSeconds = mTimeZone.offsetFromUtc(bucketStart);
+    else
+      mOffsetSeconds = bucketStart.toLocalTime().offsetFromUtc();
+# endif
+    mOffsetBucket = bucket;
+    mOffsetValid = true;
+  }
+  return mOffsetSeconds;
+}
+
+/*! \internal
+
+  Creates the tick label for \a tick with the fast label formatter, which must have been prepared
+  with \ref prepareFastFormat.
+
+  The key is split into day and time of day with integer arithmetic. The date part of the label is
+  taken from a cache that holds the formatted \c mDayFormat per day (and AM/PM half), split at the
+  time field placeholders. Only the time fields are formatted per tick.
+*/
+QString QCPAxisTickerDateTime::fastTickLabel(double tick, const QLocale &locale)
+{
+  const qint64 msecsPerDay = 86400*1000;
+  qint64 msecs = qint64(tick*1000.0); // same conversion as keyToDateTime
+  msecs += qint64(utcOffset(msecs))*1000;
+  const qint64 day = msecs >= 0 ? msecs/msecsPerDay : -((-msecs+msecsPerDay-1)/msecsPerDay);
+  const int msecsOfDay = int(msecs-day*msecsPerDay);
+  const int hour = msecsOfDay/3600000;
+  const bool pm = mFormatHasAmPm && hour >= 12;
+  
+  // get date part of label, split at time field placeholders:
+  const qint64 dayKey = day*2 + (pm ? 1 : 0);
+  QHash<qint64, QStringList>::const_iterator it = mDayLabelCache.constFind(dayKey);
+  if (it == mDayLabelCache.constEnd())
+  {
+    if (mDayLabelCache.size() > 64)
+      mDayLabelCache.clear();
+    const QDateTime dayStart(QDate::fromJulianDay(day+2440588), QTime(pm ? 12 : 0, 0), Qt::UTC); // 2440588 is the julian day of the Epoch
+    const QString dayLabel = locale.toString(dayStart, mDayFormat);
+    QStringList pieces;
+    int pieceStart = 0;
+    for (int i=0; i<dayLabel.size(); ++i)
+    {
+      if (dayLabel.at(i).unicode() == 0xE000+pieces.size())
+      {
+        pieces.append(dayLabel.mid(pieceStart, i-pieceStart));
+        pieceStart = i+1;
+      }
+    }
+    pieces.append(dayLabel.mid(pieceStart));
+    while (pieces.size() < mTimeTokens.size()+1) // placeholders were checked in prepareFastFormat, but be safe
+      pieces.append(QString());
+    it = mDayLabelCache.insert(dayKey, pieces);
+  }
+  const QStringList &pieces = it.value();
+  
+  // assemble label from date pieces and time fields:
+  QString result;
+  result.reserve(mDayFormat.size()+8);
+  result += pieces.first();
+  for (int i=0; i<mTimeTokens.size(); ++i)
+  {
+    int value = 0;
+    switch (mTimeTokens.at(i).field)
+    {
+      case tfHour: value = hour; break;
+      case tfHour12: value = hour%12 == 0 ? 12 : hour%12; break;
+      case tfMinute: value = (msecsOfDay/60000)%60; break;
+      case tfSecond: value = (msecsOfDay/1000)%60; break;
+      case tfMillisecond: value = msecsOfDay%1000; break;
+    }
+    const int width = mTimeTokens.at(i).width;
+    if (value >= 100 || width >= 3)
+      result += QLatin1Char(char('0'+value/100));
+    if (value >= 10 || width >= 2)
+      result += QLatin1Char(char('0'+(value/10)%10));
+    result += QLatin1Char(char('0'+value%10));
+    result += pieces.at(i+1);
+  }
+  return result;
+}
 /* end of 'src/axis/axistickerdatetime.cpp' */
 
 
@@ -6915,6 +8066,7 @@ QCPAxisTickerTime::QCPAxisTickerTime() :
 */
 void QCPAxisTickerTime::setTimeFormat(const QString &format)
 {
+  clearCache();
   mTimeFormat = format;
   
   // determine smallest and biggest unit in format, to optimize unit replacement and allow biggest
@@ -6946,6 +8098,7 @@ void QCPAxisTickerTime::setTimeFormat(const QString &format)
 */
 void QCPAxisTickerTime::setFieldWidth(QCPAxisTickerTime::TimeUnit unit, int width)
 {
+  clearCache();
   mFieldWidth[unit] = qMax(width, 1);
 }
 
@@ -7126,6 +8279,7 @@ QCPAxisTickerFixed::QCPAxisTickerFixed() :
 */
 void QCPAxisTickerFixed::setTickStep(double step)
 {
+  clearCache();
   if (step > 0)
     mTickStep = step;
   else
@@ -7141,6 +8295,7 @@ void QCPAxisTickerFixed::setTickStep(double step)
 */
 void QCPAxisTickerFixed::setScaleStrategy(QCPAxisTickerFixed::ScaleStrategy strategy)
 {
+  clearCache();
   mScaleStrategy = strategy;
 }
 
@@ -7241,6 +8396,7 @@ QCPAxisTickerText::QCPAxisTickerText() :
 */
 void QCPAxisTickerText::setTicks(const QMap<double, QString> &ticks)
 {
+  clearCache();
   mTicks = ticks;
 }
 
@@ -7265,6 +8421,7 @@ void QCPAxisTickerText::setTicks(const QVector<double> &positions, const QVector
 */
 void QCPAxisTickerText::setSubTickCount(int subTicks)
 {
+  clearCache();
   if (subTicks >= 0)
     mSubTickCount = subTicks;
   else
@@ -7281,6 +8438,7 @@ void QCPAxisTickerText::setSubTickCount(int subTicks)
 */
 void QCPAxisTickerText::clear()
 {
+  clearCache();
   mTicks.clear();
 }
 
@@ -7292,6 +8450,7 @@ void QCPAxisTickerText::clear()
 */
 void QCPAxisTickerText::addTick(double position, const QString &label)
 {
+  clearCache();
   mTicks.insert(position, label);
 }
 
@@ -7307,6 +8466,7 @@ void QCPAxisTickerText::addTick(double position, const QString &label)
 */
 void QCPAxisTickerText::addTicks(const QMap<double, QString> &ticks)
 {
+  clearCache();
 #if QT_VERSION < QT_VERSION_CHECK(5, 15, 0)
   mTicks.unite(ticks);
 #else
@@ -7327,6 +8487,7 @@ void QCPAxisTickerText::addTicks(const QMap<double, QString> &ticks)
 */
 void QCPAxisTickerText::addTicks(const QVector<double> &positions, const QVector<QString> &labels)
 {
+  clearCache();
   if (positions.size() != labels.size())
     qDebug() << Q_FUNC_INFO << "passed unequal length vectors for positions and labels:" << positions.size() << labels.size();
   int n = qMin(positions.size(), labels.size());
@@ -7443,6 +8604,7 @@ QCPAxisTickerPi::QCPAxisTickerPi() :
 */
 void QCPAxisTickerPi::setPiSymbol(QString symbol)
 {
+  clearCache();
   mPiSymbol = symbol;
 }
 
@@ -7454,6 +8616,7 @@ void QCPAxisTickerPi::setPiSymbol(QString symbol)
 */
 void QCPAxisTickerPi::setPiValue(double pi)
 {
+  clearCache();
   mPiValue = pi;
 }
 
@@ -7467,6 +8630,7 @@ void QCPAxisTickerPi::setPiValue(double pi)
 */
 void QCPAxisTickerPi::setPeriodicity(int multiplesOfPi)
 {
+  clearCache();
   mPeriodicity = qAbs(multiplesOfPi);
 }
 
@@ -7476,6 +8640,7 @@ void QCPAxisTickerPi::setPeriodicity(int multiplesOfPi)
 */
 void QCPAxisTickerPi::setFractionStyle(QCPAxisTickerPi::FractionStyle style)
 {
+  clearCache();
   mFractionStyle = style;
 }
 
@@ -7734,6 +8899,7 @@ QCPAxisTickerLog::QCPAxisTickerLog() :
 */
 void QCPAxisTickerLog::setLogBase(double base)
 {
+  clearCache();
   if (base > 0)
   {
     mLogBase = base;
@@ -7754,6 +8920,7 @@ void QCPAxisTickerLog::setLogBase(double base)
 */
 void QCPAxisTickerLog::setSubTickCount(int subTicks)
 {
+  clearCache();
   if (subTicks >= 0)
     mSubTickCount = subTicks;
   else
@@ -9345,6 +10512,61 @@ double QCPAxis::coordToPixel(double value) const
   }
 }
 
+/*!
+  Transforms the \a count axis coordinates at \a coords to pixel coordinates of the QCustomPlot
+  widget and writes them to \a pixels. The result is identical to calling \ref coordToPixel for
+  each element (up to floating point rounding), but the orientation, range direction and scale type
+  are resolved only once for the whole array.
+
+  For linear axes, the per-element work reduces to a single multiply-add without any branches,
+  which compilers turn into a vectorized loop. This makes the method the preferred way of mapping
+  large contiguous arrays, e.g. when plottables build their pixel geometry.
+
+  \a coords and \a pixels may point to the same array, to transform the coordinates in place.
+
+  \see coordToPixel
+*/
+void QCPAxis::coordsToPixels(const double *coords, double *pixels, int count) const
+{
+  if (count <= 0)
+    return;
+  
+  // the pixel position is an affine function of the fraction of the range (linear or logarithmic)
+  // that lies above the lower bound, so orientation and range direction only change origin and extent:
+  double origin, extent;
+  if (orientation() == Qt::Horizontal)
+  {
+    origin = !mRangeReversed ? mAxisRect->left() : mAxisRect->left()+mAxisRect->width();
+    extent = !mRangeReversed ? mAxisRect->width() : -mAxisRect->width();
+  } else // orientation() == Qt::Vertical
+  {
+    origin = !mRangeReversed ? mAxisRect->bottom() : mAxisRect->bottom()-mAxisRect->height();
+    extent = !mRangeReversed ? -mAxisRect->height() : mAxisRect->height();
+  }
+  
+  if (mScaleType == stLinear)
+  {
+    // subtract the lower bound first, folding it into the offset would cancel catastrophically for
+    // large coordinates (e.g. seconds since epoch) on small ranges:
+    const double factor = extent/mRange.size();
+    const double lower = mRange.lower;
+    for (int i=0; i<count; ++i)
+      pixels[i] = (coords[i]-lower)*factor+origin;
+  } else // mScaleType == stLogarithmic
+  {
+    const double factor = extent/qLn(mRange.upper/mRange.lower);
+    const bool negativeRange = mRange.upper < 0.0;
+    for (int i=0; i<count; ++i)
+    {
+      const double value = coords[i];
+      if (negativeRange ? value >= 0.0 : value <= 0.0) // invalid value for logarithmic scale, let coordToPixel place it outside visible range
+        pixels[i] = coordToPixel(value);
+      else
+        pixels[i] = qLn(value/mRange.lower)*factor+origin;
+    }
+  }
+}
+
 /*!
   Returns the part of the axis that is hit by \a pos (in pixels). The return value of this function
   is independent of the user-selectable parts defined with \ref setSelectableParts. Further, this
@@ -9573,7 +10795,7 @@ void QCPAxis::mouseMoveEvent(QMouseEvent *event, const QPointF &startPos)
     
     if (mParentPlot->noAntialiasingOnDrag())
       mParentPlot->setNotAntialiasedElements(QCP::aeAll);
-    mParentPlot->replot(QCustomPlot::rpQueuedReplot);
+    mParentPlot->interactionReplot(mAxisRect, QCustomPlot::rpQueuedReplot);
   }
 }
 
@@ -9642,7 +10864,7 @@ void QCPAxis::wheelEvent(QWheelEvent *event)
   const double wheelSteps = delta/120.0; // a single step delta is +/-120 usually
   const double factor = qPow(mAxisRect->rangeZoomFactor(orientation()), wheelSteps);
   scaleRange(factor, pixelToCoord(orientation() == Qt::Horizontal ? pos.x() : pos.y()));
-  mParentPlot->replot();
+  mParentPlot->interactionReplot(mAxisRect, QCustomPlot::rpRefreshHint);
 }
 
 /*! \internal
@@ -9912,7 +11134,8 @@ QCPAxisPainterPrivate::QCPAxisPainterPrivate(QCustomPlot *parentPlot) :
   abbreviateDecimalPowers(false),
   reversedEndings(false),
   mParentPlot(parentPlot),
-  mLabelCache(16) // cache at most 16 (tick) labels
+  mLabelCache(16), // cache at most 16 (tick) labels
+  mLabelDataCache(64) // measurements are small, so keep more of them than rendered labels
 {
 }
 
@@ -9932,7 +11155,7 @@ void QCPAxisPainterPrivate::draw(QCPPainter *painter)
   QByteArray newHash = generateLabelParameterHash();
   if (newHash != mLabelParameterHash)
   {
-    mLabelCache.clear();
+    clearCache();
     mLabelParameterHash = newHash;
   }
   
@@ -10127,7 +11350,7 @@ int QCPAxisPainterPrivate::size()
   QByteArray newHash = generateLabelParameterHash();
   if (newHash != mLabelParameterHash)
   {
-    mLabelCache.clear();
+    clearCache();
     mLabelParameterHash = newHash;
   }
   
@@ -10162,13 +11385,14 @@ int QCPAxisPainterPrivate::size()
 
 /*! \internal
   
-  Clears the internal label cache. Upon the next \ref draw, all labels will be created new. This
-  method is called automatically in \ref draw, if any parameters have changed that invalidate the
-  cached labels, such as font, color, etc.
+  Clears the internal label cache and the cached label measurements. Upon the next \ref draw, all
+  labels will be created new. This method is called automatically in \ref draw, if any parameters
+  have changed that invalidate the cached labels, such as font, color, etc.
 */
 void QCPAxisPainterPrivate::clearCache()
 {
   mLabelCache.clear();
+  mLabelDataCache.clear();
 }
 
 /*! \internal
@@ -10229,7 +11453,7 @@ void QCPAxisPainterPrivate::placeTickLabel(QCPPainter *painter, double position,
     if (!cachedLabel)  // no cached label existed, create it
     {
       cachedLabel = new CachedLabel;
-      TickLabelData labelData = getTickLabelData(painter->font(), text);
+      TickLabelData labelData = cachedTickLabelData(painter->font(), text);
       cachedLabel->offset = getTickLabelDrawOffset(labelData)+labelData.rotatedTotalBounds.topLeft();
       if (!qFuzzyCompare(1.0, mParentPlot->bufferDevicePixelRatio()))
       {
@@ -10265,7 +11489,7 @@ void QCPAxisPainterPrivate::placeTickLabel(QCPPainter *painter, double position,
     mLabelCache.insert(text, cachedLabel); // return label to cache or insert for the first time if newly created
   } else // label caching disabled, draw text directly on surface:
   {
-    TickLabelData labelData = getTickLabelData(painter->font(), text);
+    TickLabelData labelData = cachedTickLabelData(painter->font(), text);
     QPointF finalPosition = labelAnchor + getTickLabelDrawOffset(labelData);
     // if label would be partly clipped by widget border on sides, don't draw it (only for outside tick labels):
      bool labelClippedByBorder = false;
@@ -10531,7 +11755,7 @@ void QCPAxisPainterPrivate::getMaxTickLabelSize(const QFont &font, const QString
     finalSize = cachedLabel->pixmap.size()/mParentPlot->bufferDevicePixelRatio();
   } else // label caching disabled or no label with this text cached:
   {
-    TickLabelData labelData = getTickLabelData(font, text);
+    TickLabelData labelData = cachedTickLabelData(font, text);
     finalSize = labelData.rotatedTotalBounds.size();
   }
   
@@ -10541,6 +11765,23 @@ void QCPAxisPainterPrivate::getMaxTickLabelSize(const QFont &font, const QString
   if (finalSize.height() > tickLabelsSize->height())
     tickLabelsSize->setHeight(finalSize.height());
 }
+
+/*! \internal
+  
+  Returns the result of \ref getTickLabelData for \a font and \a text, taking it from the cache of
+  label measurements if possible. This way, the text measurement of a tick label is only done once
+  while the label parameters don't change (see \ref generateLabelParameterHash), no matter whether
+  the label is drawn via the label pixmap cache or directly (e.g. with \ref QCPPainter::pmNoCaching
+  or for margin calculation in \ref getMaxTickLabelSize).
+*/
+QCPAxisPainterPrivate::TickLabelData QCPAxisPainterPrivate::cachedTickLabelData(const QFont &font, const QString &text) const
+{
+  if (const TickLabelData *cachedData = mLabelDataCache.object(text))
+    return *cachedData;
+  TickLabelData labelData = getTickLabelData(font, text);
+  mLabelDataCache.insert(text, new TickLabelData(labelData));
+  return labelData;
+}
 /* end of 'src/axis/axis.cpp' */
 
 
@@ -10864,6 +12105,26 @@ void QCPScatterStyle::applyTo(QCPPainter *painter, const QPen &defaultPen) const
   painter->setBrush(mBrush);
 }
 
+/*!
+  Returns whether a symbol of this scatter style, drawn with \a defaultPen if the pen is undefined
+  (see \ref applyTo), completely replaces the pixels it covers, i.e. its pen and brush (or, for \ref
+  ssPixmap, the pixmap) have no transparency. A symbol drawn over an earlier one at the same
+  position then hides it completely.
+  
+  Returns false for \ref ssNone.
+*/
+bool QCPScatterStyle::isOpaque(const QPen &defaultPen) const
+{
+  if (mShape == ssNone)
+    return false;
+  if (mShape == ssPixmap)
+    return !mPixmap.hasAlphaChannel();
+  const QPen pen = mPenDefined ? mPen : defaultPen;
+  const bool penOpaque = pen.style() == Qt::NoPen || pen.brush().isOpaque();
+  const bool brushOpaque = mBrush.style() == Qt::NoBrush || mBrush.isOpaque();
+  return penOpaque && brushOpaque;
+}
+
 /*!
   Draws the scatter shape with \a painter at position \a pos.
   
@@ -11014,6 +12275,220 @@ void QCPScatterStyle::drawShape(QCPPainter *painter, double x, double y) const
     }
   }
 }
+
+/*!
+  Draws the scatter shape with \a painter at all \a positions. Positions with NaN coordinates are
+  skipped. Like \ref drawShape, this does not modify the pen or the brush on the painter, so call
+  \ref applyTo first.
+
+  If \a spriteCache is provided, the shape is rendered only once with the current pen, brush and
+  antialiasing of \a painter into a pixmap (a sprite), which is stored in \a spriteCache and
+  stamped at all positions with a single QPainter::drawPixmapFragments call. This is much faster
+  than drawing the vector shape for every position, at the cost of the symbols being aligned to
+  whole device pixels. Plottables pass the cache of their QCustomPlot if the plotting hint \ref
+  QCP::phCacheScatters is set (see \ref QCPAbstractPlottable::scatterSpriteCache).
+
+  When stamping sprites of an opaque symbol (its pen and brush have no transparency) without
+  antialiasing, each sprite pixel is either fully covered or untouched, so a stamp is completely
+  replaced by a later stamp at the same device pixel. In that case, only the last of all positions
+  whose sprites are blitted to the same device pixel is drawn. The result is pixel-identical, and
+  the number of drawn symbols is bounded by the plot area rather than the number of positions.
+
+  Sprites are only used if \a painter has neither the \ref QCPPainter::pmVectorized nor the \ref
+  QCPPainter::pmNoCaching mode (so not for exports, and not in worker threads, where QPixmaps must
+  not be created), and no scaling or rotation. Further, they aren't used for the shapes \ref
+  ssPixmap and \ref ssCustom, nor for pens and brushes that aren't solid colors. In all other
+  cases, and whenever \a spriteCache is \c nullptr, the shape is drawn with \ref drawShape at
+  each position.
+*/
+void QCPScatterStyle::drawShapes(QCPPainter *painter, const QVector<QPointF> &positions, QCache<QByteArray, QPixmap> *spriteCache) const
+{
+  double ratio = 1.0;
+#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
+#  ifdef QCP_DEVICEPIXELRATIO_FLOAT
+  ratio = painter->device()->devicePixelRatioF();
+#  else
+  ratio = painter->device()->devicePixelRatio();
+#  endif
+#endif
+  if (spriteCache && spritesApplicable(painter))
+  {
+    const QByteArray key = spriteKey(painter, ratio);
+    QPixmap sprite;
+    if (QPixmap *cachedSprite = spriteCache->object(key))
+      sprite = *cachedSprite;
+    else
+    {
+      sprite = createSprite(painter, ratio);
+      spriteCache->insert(key, new QPixmap(sprite));
+    }
+    
+    // skip stamps that are completely replaced by later ones. This requires the fragments to be
+    // blitted without any scaling, i.e. the 1/ratio scaling below must exactly cancel the ratio:
+    QVector<QPointF> uniquePositions;
+    const QVector<QPointF> *drawnPositions = &positions;
+    if (positions.size() > 1 && overdrawInvisible(painter) && ratio*(1.0/ratio) == 1.0 &&
+        !painter->testRenderHint(QPainter::Antialiasing) && !painter->testRenderHint(QPainter::SmoothPixmapTransform))
+    {
+      uniquePositions = uniqueSpritePositions(painter, positions, sprite.size());
+      drawnPositions = &uniquePositions;
+    }
+    
+    // the sprite has device resolution, so scale the fragments by 1/ratio to get logical size:
+    const QRectF sourceRect(0, 0, sprite.width(), sprite.height());
+    QVector<QPainter::PixmapFragment> fragments;
+    fragments.reserve(drawnPositions->size());
+    foreach (const QPointF &pos, *drawnPositions)
+    {
+      if (!qIsNaN(pos.x()) && !qIsNaN(pos.y()))
+        fragments.append(QPainter::PixmapFragment::create(pos, sourceRect, 1.0/ratio, 1.0/ratio));
+    }
+    painter->drawPixmapFragments(fragments.constData(), fragments.size(), sprite);
+  } else
+  {
+    foreach (const QPointF &pos, positions)
+    {
+      if (!qIsNaN(pos.x()) && !qIsNaN(pos.y()))
+        drawShape(painter, pos.x(), pos.y());
+    }
+  }
+}
+
+/*! \internal
+
+  Returns whether \ref drawShapes may stamp this scatter shape as a sprite with \a painter, given
+  its current mode, transform, pen and brush.
+*/
+bool QCPScatterStyle::spritesApplicable(const QCPPainter *painter) const
+{
+  if (mShape == ssNone || mShape == ssPixmap || mShape == ssCustom)
+    return false;
+  if (painter->modes().testFlag(QCPPainter::pmVectorized) || painter->modes().testFlag(QCPPainter::pmNoCaching))
+    return false;
+  if (painter->transform().type() > QTransform::TxTranslate)
+    return false;
+  const QPen pen = painter->pen();
+  if (pen.style() != Qt::NoPen && pen.brush().style() != Qt::SolidPattern)
+    return false;
+  const Qt::BrushStyle brushStyle = painter->brush().style();
+  return brushStyle == Qt::NoBrush || brushStyle == Qt::SolidPattern;
+}
+
+/*! \internal
+
+  Returns whether the pen and brush of \a painter are opaque, so a stamp of this scatter shape
+  completely replaces the pixels it covers (unless antialiased). Used by \ref drawShapes to skip
+  sprite stamps that are replaced by later ones.
+*/
+bool QCPScatterStyle::overdrawInvisible(const QCPPainter *painter) const
+{
+  if (mShape == ssNone)
+    return false;
+  const QPen pen = painter->pen();
+  const QBrush brush = painter->brush();
+  const bool penOpaque = pen.style() == Qt::NoPen || pen.brush().isOpaque();
+  const bool brushOpaque = brush.style() == Qt::NoBrush || brush.isOpaque();
+  return penOpaque && brushOpaque;
+}
+
+/*! \internal
+
+  Returns the sprite centers for stamping a sprite of \a spriteSize (in device pixels) at \a
+  positions with \a painter, without the positions whose stamp is replaced by a later stamp.
+
+  The top left corner of each stamp is rounded to the device pixel the paint engine would blit it
+  to, and the returned centers are derived from these snapped corners. Since the stamps are then
+  drawn at the snapped centers, the paint engine blits them to exactly the pixels that were compared
+  here, without rounding of its own. Of all stamps at the same device pixel
+  only the last one is kept, since it covers all pixels of the previous ones while keeping the
+  order relative to other stamps. Positions with NaN coordinates are dropped.
+
+  The memory and time needed depend only on the number of positions, not on the plot area.
+*/
+QVector<QPointF> QCPScatterStyle::uniqueSpritePositions(const QCPPainter *painter, const QVector<QPointF> &positions, const QSize &spriteSize) const
+{
+  const QTransform toDevice = painter->deviceTransform();
+  const QTransform toLogical = toDevice.inverted();
+  const QPointF halfSprite(spriteSize.width()*0.5, spriteSize.height()*0.5);
+  QVector<QPoint> origins;
+  origins.reserve(positions.size());
+  foreach (const QPointF &pos, positions)
+  {
+    if (!qIsNaN(pos.x()) && !qIsNaN(pos.y()))
+      origins.append((toDevice.map(pos)-halfSprite).toPoint());
+  }
+  
+  // sort the stamps by origin and, for equal origins, by drawing order, then keep the last of each origin:
+  QVector<int> order(origins.size());
+  for (int i=0; i<order.size(); ++i)
+    order[i] = i;
+  std::sort(order.begin(), order.end(), [&origins](int a, int b)
+  {
+    const QPoint &pa = origins.at(a);
+    const QPoint &pb = origins.at(b);
+    if (pa.y() != pb.y()) return pa.y() < pb.y();
+    if (pa.x() != pb.x()) return pa.x() < pb.x();
+    return a < b;
+  });
+  QVector<bool> keep(origins.size(), false);
+  for (int i=0; i<order.size(); ++i)
+  {
+    if (i == order.size()-1 || origins.at(order.at(i+1)) != origins.at(order.at(i)))
+      keep[order.at(i)] = true;
+  }
+  
+  QVector<QPointF> result;
+  result.reserve(origins.size());
+  for (int i=0; i<origins.size(); ++i)
+  {
+    if (keep.at(i))
+      result.append(toLogical.map(QPointF(origins.at(i))+halfSprite));
+  }
+  return result;
+}
+
+/*! \internal
+
+  Returns the key under which the sprite for this scatter style, drawn with the current state of \a
+  painter on a device with pixel \a ratio, is stored in the sprite cache of \ref drawShapes.
+*/
+QByteArray QCPScatterStyle::spriteKey(const QCPPainter *painter, double ratio) const
+{
+  const QPen pen = painter->pen();
+  const QBrush brush = painter->brush();
+  return QByteArray::number(int(mShape))+' '+
+      QByteArray::number(mSize)+' '+
+      QByteArray::number(ratio)+' '+
+      QByteArray::number(int(pen.style()))+' '+
+      QByteArray::number(pen.color().rgba(), 36)+' '+
+      QByteArray::number(pen.widthF())+' '+
+      QByteArray::number(int(pen.capStyle())+16*int(pen.joinStyle())+256*int(pen.isCosmetic()))+' '+
+      QByteArray::number(int(brush.style()))+' '+
+      QByteArray::number(brush.color().rgba(), 36)+' '+
+      QByteArray::number(int(painter->modes())+256*int(painter->testRenderHint(QPainter::Antialiasing)));
+}
+
+/*! \internal
+
+  Renders this scatter shape with the pen, brush and antialiasing of \a painter into a new
+  transparent pixmap with device pixel \a ratio. The shape is centered in the pixmap, and a margin
+  for the pen width and antialiasing is added around it.
+*/
+QPixmap QCPScatterStyle::createSprite(const QCPPainter *painter, double ratio) const
+{
+  const double penWidth = painter->pen().style() == Qt::NoPen ? 0 : qMax(1.0, painter->pen().widthF());
+  const int extent = qCeil(mSize+penWidth+2); // in logical pixels
+  QPixmap sprite(qCeil(extent*ratio), qCeil(extent*ratio));
+  sprite.fill(Qt::transparent);
+  QCPPainter spritePainter(&sprite);
+  spritePainter.setModes(painter->modes());
+  spritePainter.setRenderHint(QPainter::Antialiasing, painter->testRenderHint(QPainter::Antialiasing));
+  spritePainter.scale(ratio, ratio); // cosmetic pens stay one device pixel wide, like on the target
+  spritePainter.setPen(painter->pen());
+  spritePainter.setBrush(painter->brush());
+  drawShape(&spritePainter, extent*0.5, extent*0.5);
+  return sprite;
+}
 /* end of 'src/scatterstyle.cpp' */
 
 
@@ -11943,6 +13418,19 @@ void QCPAbstractPlottable::applyScattersAntialiasingHint(QCPPainter *painter) co
   applyAntialiasingHint(painter, mAntialiasedScatters, QCP::aeScatters);
 }
 
+/*! \internal
+
+  Returns the scatter sprite cache of the parent plot, if the plotting hint \ref
+  QCP::phCacheScatters is set and \a painter isn't used for an export. Otherwise returns \c
+  nullptr. The result is meant to be passed to \ref QCPScatterStyle::drawShapes.
+*/
+QCache<QByteArray, QPixmap> *QCPAbstractPlottable::scatterSpriteCache(const QCPPainter *painter) const
+{
+  if (mParentPlot && mParentPlot->plottingHints().testFlag(QCP::phCacheScatters) && !painter->modes().testFlag(QCPPainter::pmNoCaching))
+    return &mParentPlot->mScatterSpriteCache;
+  return nullptr;
+}
+
 /* inherits documentation from base class */
 void QCPAbstractPlottable::selectEvent(QMouseEvent *event, bool additive, const QVariant &details, bool *selectionStateChanged)
 {
@@ -11988,6 +13476,244 @@ void QCPAbstractPlottable::deselectEvent(bool *selectionStateChanged)
 /* end of 'src/plottable.cpp' */
 
 
+/* including file 'src/pointindex.cpp'     */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPPointIndex
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPPointIndex
+  \brief A uniform grid which finds the points (and line segments) inside a rect quickly
+
+  Hit-testing a plottable (\ref QCPAbstractPlottable::selectTest) requires finding the data points
+  closest to the mouse position. For plottables whose data isn't sorted by the pixel position, like
+  QCPCurve or graphs with many points per key, this would mean iterating over all data points. This
+  class divides the bounding box of the points into a uniform grid of cells and stores for each
+  cell the indices of the points (and optionally of the line segments between consecutive points)
+  inside it. Finding the points in a rect then only needs to look at the cells overlapping the rect.
+
+  The index is usually not used directly, but via \ref QCPAbstractPlottable1D::pointIndex, which
+  builds it from the plottable's data and keeps it up to date.
+*/
+
+/*!
+  Creates an empty point index. Call \ref build to fill it.
+*/
+QCPPointIndex::QCPPointIndex() :
+  mPointCount(0),
+  mColumns(0),
+  mRows(0),
+  mCellWidth(1),
+  mCellHeight(1)
+{
+}
+
+/*!
+  Removes all points and segments from the index and frees the memory.
+*/
+void QCPPointIndex::clear()
+{
+  mBounds = QRectF();
+  mPointCount = 0;
+  mColumns = 0;
+  mRows = 0;
+  mPointCellStart = QVector<int>();
+  mPointEntries = QVector<int>();
+  mSegmentCellStart = QVector<int>();
+  mSegmentEntries = QVector<int>();
+  mLongSegments = QVector<int>();
+}
+
+/*!
+  Builds the index for \a points. The index of a point in \a points is what \ref findPoints returns.
+  Points with NaN or infinite coordinates are not indexed.
+
+  If \a indexSegments is true, the line segments between consecutive points are indexed, too. The
+  segment from point \a i to point \a i+1 has the index \a i. Segments are registered in all cells
+  their bounding box overlaps. Segments which span more than a few cells are kept in a separate list
+  which \ref findSegments always returns, so a few long segments don't bloat the index.
+*/
+void QCPPointIndex::build(const QVector<QPointF> &points, bool indexSegments)
+{
+  clear();
+  
+  // determine bounds of valid points:
+  double minX = (std::numeric_limits<double>::max)();
+  double minY = (std::numeric_limits<double>::max)();
+  double maxX = -(std::numeric_limits<double>::max)();
+  double maxY = -(std::numeric_limits<double>::max)();
+  int validCount = 0;
+  for (int i=0; i<points.size(); ++i)
+  {
+    const QPointF &p = points.at(i);
+    if (!qIsFinite(p.x()) || !qIsFinite(p.y()))
+      continue;
+    if (p.x() < minX) minX = p.x();
+    if (p.x() > maxX) maxX = p.x();
+    if (p.y() < minY) minY = p.y();
+    if (p.y() > maxY) maxY = p.y();
+    ++validCount;
+  }
+  if (validCount == 0)
+    return;
+  
+  // choose grid size such that there are a few points per cell on average:
+  const int gridSize = qBound(1, int(qSqrt(validCount/4.0)), 4096);
+  mBounds = QRectF(minX, minY, maxX-minX, maxY-minY);
+  mPointCount = validCount;
+  mColumns = maxX > minX ? gridSize : 1;
+  mRows = maxY > minY ? gridSize : 1;
+  mCellWidth = maxX > minX ? (maxX-minX)/mColumns : 1.0;
+  mCellHeight = maxY > minY ? (maxY-minY)/mRows : 1.0;
+  const int cellCount = mColumns*mRows;
+  
+  // fill point cells (counting sort into one contiguous entry vector):
+  QVector<int> pointCells(points.size(), -1);
+  mPointCellStart.fill(0, cellCount+1);
+  for (int i=0; i<points.size(); ++i)
+  {
+    const QPointF &p = points.at(i);
+    if (!qIsFinite(p.x()) || !qIsFinite(p.y()))
+      continue;
+    pointCells[i] = row(p.y())*mColumns + column(p.x());
+    ++mPointCellStart[pointCells.at(i)+1];
+  }
+  for (int c=0; c<cellCount; ++c)
+    mPointCellStart[c+1] += mPointCellStart.at(c);
+  mPointEntries.resize(validCount);
+  QVector<int> fillPos = mPointCellStart;
+  for (int i=0; i<points.size(); ++i)
+  {
+    if (pointCells.at(i) >= 0)
+      mPointEntries[fillPos[pointCells.at(i)]++] = i;
+  }
+  
+  if (!indexSegments)
+    return;
+  
+  // fill segment cells, two passes like for points:
+  const int maxSegmentCells = 16;
+  mSegmentCellStart.fill(0, cellCount+1);
+  for (int pass=0; pass<2; ++pass)
+  {
+    if (pass == 1)
+    {
+      for (int c=0; c<cellCount; ++c)
+        mSegmentCellStart[c+1] += mSegmentCellStart.at(c);
+      mSegmentEntries.resize(mSegmentCellStart.last());
+      fillPos = mSegmentCellStart;
+    }
+    for (int i=0; i<points.size()-1; ++i)
+    {
+      if (pointCells.at(i) < 0 || pointCells.at(i+1) < 0)
+        continue;
+      const int column1 = pointCells.at(i)%mColumns;
+      const int column2 = pointCells.at(i+1)%mColumns;
+      const int row1 = pointCells.at(i)/mColumns;
+      const int row2 = pointCells.at(i+1)/mColumns;
+      const int columnBegin = qMin(column1, column2), columnEnd = qMax(column1, column2);
+      const int rowBegin = qMin(row1, row2), rowEnd = qMax(row1, row2);
+      if ((columnEnd-columnBegin+1)*(rowEnd-rowBegin+1) > maxSegmentCells)
+      {
+        if (pass == 0)
+          mLongSegments.append(i);
+        continue;
+      }
+      for (int r=rowBegin; r<=rowEnd; ++r)
+      {
+        for (int c=columnBegin; c<=columnEnd; ++c)
+        {
+          if (pass == 0)
+            ++mSegmentCellStart[r*mColumns+c+1];
+          else
+            mSegmentEntries[fillPos[r*mColumns+c]++] = i;
+        }
+      }
+    }
+  }
+}
+
+/*!
+  Appends the indices of all points in the cells which overlap \a rect to \a points. Since whole
+  cells are returned, some of the points may lie outside of \a rect.
+*/
+void QCPPointIndex::findPoints(const QRectF &rect, QVector<int> &points) const
+{
+  int columnBegin, columnEnd, rowBegin, rowEnd;
+  if (!cellRange(rect, columnBegin, columnEnd, rowBegin, rowEnd))
+    return;
+  for (int r=rowBegin; r<=rowEnd; ++r)
+  {
+    const int cellBegin = mPointCellStart.at(r*mColumns+columnBegin);
+    const int cellEnd = mPointCellStart.at(r*mColumns+columnEnd+1); // cells of one row are contiguous
+    for (int k=cellBegin; k<cellEnd; ++k)
+      points.append(mPointEntries.at(k));
+  }
+}
+
+/*!
+  Appends the indices of all line segments which may intersect \a rect to \a segments, without
+  duplicates. This includes all segments in the cells which overlap \a rect as well as all long
+  segments. Only returns segments if the index was built with \a indexSegments set to true.
+*/
+void QCPPointIndex::findSegments(const QRectF &rect, QVector<int> &segments) const
+{
+  if (mSegmentCellStart.isEmpty())
+    return;
+  const int oldSize = segments.size();
+  segments += mLongSegments;
+  int columnBegin, columnEnd, rowBegin, rowEnd;
+  if (cellRange(rect, columnBegin, columnEnd, rowBegin, rowEnd))
+  {
+    for (int r=rowBegin; r<=rowEnd; ++r)
+    {
+      const int cellBegin = mSegmentCellStart.at(r*mColumns+columnBegin);
+      const int cellEnd = mSegmentCellStart.at(r*mColumns+columnEnd+1);
+      for (int k=cellBegin; k<cellEnd; ++k)
+        segments.append(mSegmentEntries.at(k));
+    }
+  }
+  // segments spanning multiple cells were found multiple times:
+  std::sort(segments.begin()+oldSize, segments.end());
+  segments.erase(std::unique(segments.begin()+oldSize, segments.end()), segments.end());
+}
+
+/*! \internal
+
+  Returns the grid column of the x-coordinate \a x, bounded to the valid columns.
+*/
+int QCPPointIndex::column(double x) const
+{
+  return qBound(0, int((x-mBounds.left())/mCellWidth), mColumns-1);
+}
+
+/*! \internal
+
+  Returns the grid row of the y-coordinate \a y, bounded to the valid rows.
+*/
+int QCPPointIndex::row(double y) const
+{
+  return qBound(0, int((y-mBounds.top())/mCellHeight), mRows-1);
+}
+
+/*! \internal
+
+  Determines the range of cells (inclusive) which overlap \a rect. Returns false if \a rect
+  doesn't overlap the bounds of the index at all.
+*/
+bool QCPPointIndex::cellRange(const QRectF &rect, int &columnBegin, int &columnEnd, int &rowBegin, int &rowEnd) const
+{
+  if (mPointCount == 0 || !(rect.right() >= mBounds.left() && rect.left() <= mBounds.right() && rect.bottom() >= mBounds.top() && rect.top() <= mBounds.bottom())) // also catches NaN rects
+    return false;
+  columnBegin = rect.left() > mBounds.left() ? column(rect.left()) : 0;
+  columnEnd = rect.right() < mBounds.right() ? column(rect.right()) : mColumns-1;
+  rowBegin = rect.top() > mBounds.top() ? row(rect.top()) : 0;
+  rowEnd = rect.bottom() < mBounds.bottom() ? row(rect.bottom()) : mRows-1;
+  return true;
+}
+/* end of 'src/pointindex.cpp' */
+
+
 /* including file 'src/item.cpp'            */
 /* modified 2021-03-29T02:30:44, size 49486 */
 
@@ -13605,6 +15331,7 @@ QCustomPlot::QCustomPlot(QWidget *parent) :
   mInteractions(QCP::iNone),
   mSelectionTolerance(8),
   mNoAntialiasingOnDrag(false),
+  mProgressiveRefineDelay(150),
   mBackgroundBrush(Qt::white, Qt::SolidPattern),
   mBackgroundScaled(true),
   mBackgroundScaledMode(Qt::KeepAspectRatioByExpanding),
@@ -13614,6 +15341,7 @@ QCustomPlot::QCustomPlot(QWidget *parent) :
   mSelectionRectMode(QCP::srmNone),
   mSelectionRect(nullptr),
   mOpenGl(false),
+  mParallelRasterization(false),
   mMouseHasMoved(false),
   mMouseEventLayerable(nullptr),
   mMouseSignalLayerable(nullptr),
@@ -13621,6 +15349,14 @@ QCustomPlot::QCustomPlot(QWidget *parent) :
   mReplotQueued(false),
   mReplotTime(0),
   mReplotTimeAverage(0),
+  mStaticLayersValid(false),
+  mLayoutValid(false),
+  mRasterThreadPool(nullptr),
+  mRenderThread(nullptr),
+  mProfiler(nullptr),
+  mCoarseReplotTimer(nullptr),
+  mRefineReplotTimer(nullptr),
+  mCoarseReplot(false),
   mOpenGlMultisamples(16),
   mOpenGlAntialiasedElementsBackup(QCP::aeNone),
   mOpenGlCacheLabelsBackup(true)
@@ -13642,6 +15378,14 @@ QCustomPlot::QCustomPlot(QWidget *parent) :
   
   mOpenGlAntialiasedElementsBackup = mAntialiasedElements;
   mOpenGlCacheLabelsBackup = mPlottingHints.testFlag(QCP::phCacheLabels);
+  // timers of progressive interaction (QCP::phProgressiveInteraction):
+  mCoarseReplotTimer = new QTimer(this);
+  mCoarseReplotTimer->setSingleShot(true);
+  mCoarseReplotTimer->setInterval(16);
+  connect(mCoarseReplotTimer, SIGNAL(timeout()), this, SLOT(coarseReplot()));
+  mRefineReplotTimer = new QTimer(this);
+  mRefineReplotTimer->setSingleShot(true);
+  connect(mRefineReplotTimer, SIGNAL(timeout()), this, SLOT(refineReplot()));
   // create initial layers:
   mLayers.append(new QCPLayer(this, QLatin1String("background")));
   mLayers.append(new QCPLayer(this, QLatin1String("grid")));
@@ -13691,6 +15435,12 @@ QCustomPlot::QCustomPlot(QWidget *parent) :
 
 QCustomPlot::~QCustomPlot()
 {
+  if (mRenderThread)
+  {
+    mRenderThread->stop();
+    delete mRenderThread;
+    mRenderThread = nullptr;
+  }
   clearPlottables();
   clearItems();
 
@@ -13703,6 +15453,8 @@ QCustomPlot::~QCustomPlot()
   mCurrentLayer = nullptr;
   qDeleteAll(mLayers); // don't use removeLayer, because it would prevent the last layer to be removed
   mLayers.clear();
+  delete mProfiler;
+  mProfiler = nullptr;
 }
 
 /*!
@@ -13913,6 +15665,24 @@ void QCustomPlot::setNoAntialiasingOnDrag(bool enabled)
   mNoAntialiasingOnDrag = enabled;
 }
 
+/*!
+  Sets the time in milliseconds the user input must be idle during a range drag or zoom, before
+  the plot is replotted in full detail. This is only relevant if the plotting hint \ref
+  QCP::phProgressiveInteraction is set.
+  
+  With progressive interaction, every drag or wheel event only shifts and scales the last rendered
+  contents of the axis rect, which is immediate regardless of the data size. Coarse frames, which
+  are drawn without antialiasing and with graphs reduced to about two points per pixel (see \ref
+  QCPGraph::getOptimizedLineData), follow at a rate throttled by their own replot time. Once no
+  further input arrives for \a msec milliseconds, a regular replot restores full detail.
+  
+  The default is 150 milliseconds.
+*/
+void QCustomPlot::setProgressiveRefineDelay(int msec)
+{
+  mProgressiveRefineDelay = qMax(0, msec);
+}
+
 /*!
   Sets the plotting hints for this QCustomPlot instance as an \a or combination of QCP::PlottingHint.
   
@@ -13920,7 +15690,18 @@ void QCustomPlot::setNoAntialiasingOnDrag(bool enabled)
 */
 void QCustomPlot::setPlottingHints(const QCP::PlottingHints &hints)
 {
+  const bool recreateBuffers = hints.testFlag(QCP::phRasterizeLines) != mPlottingHints.testFlag(QCP::phRasterizeLines);
   mPlottingHints = hints;
+  if (mPlottingHints.testFlag(QCP::phParallelGeometry) && !mRasterThreadPool) // phParallelGeometry shares the pool of setParallelRasterization
+  {
+    mRasterThreadPool = new QThreadPool(this);
+    mRasterThreadPool->setMaxThreadCount(QThread::idealThreadCount());
+  }
+  if (recreateBuffers) // phRasterizeLines requires QImage based paint buffers
+  {
+    mPaintBuffers.clear();
+    setupPaintBuffers();
+  }
 }
 
 /*!
@@ -14098,6 +15879,119 @@ void QCustomPlot::setOpenGl(bool enabled, int multisampling)
 #endif
 }
 
+/*!
+  If \a enabled is set to true, QCustomPlot uses QImage based paint buffers (\ref
+  QCPPaintBufferImage) and rasterizes independent paint buffers concurrently on a thread pool with
+  \a threadCount threads during a \ref replot. If \a threadCount is zero, the number of threads is
+  chosen according to QThread::idealThreadCount. The GUI thread only waits for the rasterization to
+  finish and composites the buffers as usual.
+
+  Each paint buffer that needs to be redrawn becomes one job. Further, if all layerables of a paint
+  buffer are clipped to mutually disjoint rects (e.g. the plottables of a plot with multiple axis
+  rects, placed on a layer in mode \ref QCPLayer::lmBuffered), each of those rects is rasterized as a
+  separate job. So to benefit from this setting, put layers whose rendering is expensive into \ref
+  QCPLayer::lmBuffered mode.
+
+  While parallel rasterization is active, tick label pixmap caching (\ref QCP::phCacheLabels) is
+  bypassed during replots, because QPixmaps must not be created outside the GUI thread. Layerables
+  which draw QPixmaps (e.g. axis rect backgrounds or \ref QCPScatterStyle::ssPixmap) require a
+  platform that supports threaded pixmaps, which is the case for the usual raster platforms.
+
+  Since the layerables draw text in the worker threads, parallel rasterization also requires a
+  platform that supports font rendering outside the GUI thread (see
+  QFontDatabase::supportsThreadedFontRendering). If it doesn't, parallel rasterization is not
+  enabled, a debug message is printed and the buffers keep being drawn serially in the GUI thread,
+  so \ref parallelRasterization returns false.
+
+  If OpenGL is enabled (\ref setOpenGl), it takes precedence and this setting has no effect.
+*/
+void QCustomPlot::setParallelRasterization(bool enabled, int threadCount)
+{
+  if (enabled && !QFontDatabase::supportsThreadedFontRendering())
+  {
+    qDebug() << Q_FUNC_INFO << "Platform doesn't support threaded font rendering, continuing with serial rasterization.";
+    enabled = false;
+  }
+  mParallelRasterization = enabled;
+  if (mParallelRasterization)
+  {
+    if (!mRasterThreadPool)
+      mRasterThreadPool = new QThreadPool(this);
+    mRasterThreadPool->setMaxThreadCount(threadCount > 0 ? threadCount : QThread::idealThreadCount());
+  }
+  // recreate all paint buffers:
+  mPaintBuffers.clear();
+  setupPaintBuffers();
+}
+
+/*!
+  If \a enabled is set to true, replots are no longer performed in the GUI thread. Instead, \ref
+  replot only requests a new frame from a dedicated \ref QCPRenderThread, which draws the entire
+  plot onto a QImage and returns. Once the frame is finished, the widget is updated and \ref
+  afterReplot is emitted. \ref paintEvent then only blits the most recent finished frame, so a
+  heavy replot doesn't block input handling or other events of the GUI thread.
+
+  Since the render thread accesses the plot while drawing, the plot must not be modified
+  concurrently. Data should be handed to the render thread as snapshots via \ref
+  QCPRenderThread::submitData, which are applied right before the next frame is drawn. Any other
+  modification of the plot from the GUI thread (e.g. setting axis ranges, adding or removing
+  plottables) must be done while holding \ref QCPRenderThread::plotMutex. The mouse, wheel and
+  resize event handlers of QCustomPlot hold this mutex already while emitting signals like \ref
+  mousePress or \ref plottableClick, so connected slots may modify the plot directly. \ref
+  toPixmap, \ref toImage, \ref toPainter and \ref savePdf lock the mutex as well. Since the mutex is
+  recursive, these methods may be called from such slots, and slots may lock the mutex again
+  themselves.
+
+  Paint buffers and the plotting hints \ref QCP::phSkipStaticLayers and \ref QCP::phCacheLabels are
+  not used while asynchronous rendering is active. Everything drawn in the render thread must work
+  without creating QPixmaps, which is only allowed in the GUI thread. For example, the background
+  pixmaps of the plot, the axis rects and the polar axes are converted to QImages when they are set
+  (\ref setBackground), and are scaled and drawn as QImages. Custom layerables must follow the same
+  restriction if asynchronous rendering is used. Note that a scaled \ref QCPItemPixmap still
+  creates its scaled pixmap when its size changes, so it should only be used with a fixed size.
+
+  \see renderThread
+*/
+void QCustomPlot::setAsyncRendering(bool enabled)
+{
+  if (enabled && !mRenderThread)
+  {
+    mRenderThread = new QCPRenderThread(this);
+    connect(mRenderThread, SIGNAL(frameReady()), this, SLOT(update()));
+    connect(mRenderThread, SIGNAL(frameReady()), this, SIGNAL(afterReplot()));
+    mRenderThread->start();
+  } else if (!enabled && mRenderThread)
+  {
+    mRenderThread->stop();
+    delete mRenderThread;
+    mRenderThread = nullptr;
+  }
+  replot(rpQueuedReplot);
+}
+
+/*!
+  If \a enabled is set to true, replots record the time spent in each of their stages, down to the
+  draw call of each layerable, in a \ref QCPProfiler which can then be accessed with \ref profiler.
+  This helps to find the graphs, axes or items that take up most of the time of a replot. See the
+  \ref QCPProfiler documentation for details, e.g. how to export the recording as a Chrome trace or
+  how to show an overlay with live numbers.
+  
+  Disabling profiling deletes the profiler with its recorded spans, and \ref profiler returns \c
+  nullptr again.
+*/
+void QCustomPlot::setProfilingEnabled(bool enabled)
+{
+  QMutexLocker plotLocker(mRenderThread ? mRenderThread->plotMutex() : nullptr); // see setAsyncRendering
+  if (enabled && !mProfiler)
+  {
+    mProfiler = new QCPProfiler;
+  } else if (!enabled && mProfiler)
+  {
+    delete mProfiler;
+    mProfiler = nullptr;
+  }
+}
+
 /*!
   Sets the viewport of this QCustomPlot. Usually users of QCustomPlot don't need to change the
   viewport manually.
@@ -14166,7 +16060,8 @@ void QCustomPlot::setBufferDevicePixelRatio(double ratio)
 void QCustomPlot::setBackground(const QPixmap &pm)
 {
   mBackgroundPixmap = pm;
-  mScaledBackgroundPixmap = QPixmap();
+  mBackgroundImage = pm.toImage();
+  mScaledBackgroundImage = QImage();
 }
 
 /*!
@@ -14197,7 +16092,8 @@ void QCustomPlot::setBackground(const QBrush &brush)
 void QCustomPlot::setBackground(const QPixmap &pm, bool scaled, Qt::AspectRatioMode mode)
 {
   mBackgroundPixmap = pm;
-  mScaledBackgroundPixmap = QPixmap();
+  mBackgroundImage = pm.toImage();
+  mScaledBackgroundImage = QImage();
   mBackgroundScaled = scaled;
   mBackgroundScaledMode = mode;
 }
@@ -15083,6 +16979,7 @@ void QCustomPlot::deselectAll()
     foreach (QCPLayerable *layerable, layer->children())
       layerable->deselectEvent(nullptr);
   }
+  invalidateStaticLayers(); // e.g. legend items may have changed their selection state
 }
 
 /*!
@@ -15109,8 +17006,18 @@ void QCustomPlot::deselectAll()
   If a layer is in mode \ref QCPLayer::lmBuffered (\ref QCPLayer::setMode), it is also possible to
   replot only that specific layer via \ref QCPLayer::replot. See the documentation there for
   details.
+
+  If the plotting hint \ref QCP::phSkipStaticLayers is set and neither the viewport, the axis rect
+  geometry nor the axis ranges changed since the last replot, only the paint buffers that hold
+  plottables or items are redrawn. This makes replots after pure data changes considerably cheaper,
+  if the layer of the plottables is in mode \ref QCPLayer::lmBuffered (otherwise it shares its paint
+  buffer with the grid and axes, which then are redrawn as well).
+
+  Similarly, if the plotting hint \ref QCP::phSkipLayout is set and nothing that affects the layout
+  changed since the last replot, the margin and layout passes are skipped (see \ref updateLayout).
+  The time saved is reflected in \ref replotTime.
   
-  \see replotTime
+  \see replotTime, invalidateStaticLayers, invalidateLayout
 */
 void QCustomPlot::replot(QCustomPlot::RefreshPriority refreshPriority)
 {
@@ -15126,6 +17033,13 @@ void QCustomPlot::replot(QCustomPlot::RefreshPriority refreshPriority)
   
   if (mReplotting) // incase signals loop back to replot slot
     return;
+  if (mRenderThread) // asynchronous rendering, the frame is drawn by the render thread (afterReplot is emitted once it's ready)
+  {
+    mReplotQueued = false;
+    emit beforeReplot();
+    mRenderThread->requestFrame();
+    return;
+  }
   mReplotting = true;
   mReplotQueued = false;
   emit beforeReplot();
@@ -15137,19 +17051,80 @@ void QCustomPlot::replot(QCustomPlot::RefreshPriority refreshPriority)
   QElapsedTimer replotTimer;
   replotTimer.start();
 # endif
+  if (mProfiler)
+    mProfiler->beginFrame();
+  const qint64 profilerStart = mProfiler ? mProfiler->now() : 0;
   
   updateLayout();
-  // draw all layered objects (grid, axes, plottables, items, legend,...) into their buffers:
-  setupPaintBuffers();
+  {
+    QCPProfileScope buffersScope(mProfiler, "buffers", QLatin1String("setupPaintBuffers"));
+    setupPaintBuffers();
+  }
+  
+  // determine which paint buffers need to be redrawn. If only data changed since the last replot,
+  // buffers without plottables/items (background, grid, axes,...) keep their contents:
+  QVector<double> staticState;
+  if (mPlottingHints.testFlag(QCP::phSkipStaticLayers))
+    staticState = staticLayerState();
+  const bool skipStaticLayers = mPlottingHints.testFlag(QCP::phSkipStaticLayers) && mStaticLayersValid && staticState == mStaticLayerState;
+  QList<QCPAbstractPaintBuffer*> dirtyBuffers;
+  foreach (QSharedPointer<QCPAbstractPaintBuffer> buffer, mPaintBuffers)
+  {
+    if (!skipStaticLayers || buffer->invalidated())
+      dirtyBuffers.append(buffer.data());
+  }
   foreach (QCPLayer *layer, mLayers)
-    layer->drawToPaintBuffer();
+  {
+    QSharedPointer<QCPAbstractPaintBuffer> pb = layer->mPaintBuffer.toStrongRef();
+    if (pb && !dirtyBuffers.contains(pb.data()) && layer->hasDynamicContent())
+      dirtyBuffers.append(pb.data());
+  }
+  
+  // compute the geometry of the graphs that are about to be drawn concurrently, if enabled:
+  QList<QCPGraph*> preparedGraphs;
+  if (mPlottingHints.testFlag(QCP::phParallelGeometry))
+  {
+    QList<QCPLayer*> dirtyLayers;
+    foreach (QCPLayer *layer, mLayers)
+    {
+      if (dirtyBuffers.contains(layer->mPaintBuffer.toStrongRef().data()))
+        dirtyLayers.append(layer);
+    }
+    preparedGraphs = prepareGraphGeometry(dirtyLayers);
+  }
+  
+  // draw all layered objects (grid, axes, plottables, items, legend,...) into their dirty buffers:
+  foreach (QCPAbstractPaintBuffer *buffer, dirtyBuffers)
+    buffer->clear(Qt::transparent);
+  if (mParallelRasterization && !mOpenGl && QFontDatabase::supportsThreadedFontRendering()) // see setParallelRasterization
+  {
+    drawPaintBuffersParallel(dirtyBuffers);
+  } else
+  {
+    foreach (QCPLayer *layer, mLayers)
+    {
+      if (dirtyBuffers.contains(layer->mPaintBuffer.toStrongRef().data()))
+        layer->drawToPaintBuffer();
+    }
+  }
+  discardGraphGeometry(preparedGraphs);
   foreach (QSharedPointer<QCPAbstractPaintBuffer> buffer, mPaintBuffers)
     buffer->setInvalidated(false);
+  mStaticLayerState = staticState;
+  mStaticLayersValid = true;
+  mInteractionSnapshot = QPixmap(); // paint buffers are up to date again
+  if (mPlottingHints.testFlag(QCP::phProgressiveInteraction))
+    recordRenderedRanges();
   
   if ((refreshPriority == rpRefreshHint && mPlottingHints.testFlag(QCP::phImmediateRefresh)) || refreshPriority==rpImmediateRefresh)
     repaint();
   else
     update();
+  if (mProfiler)
+  {
+    mProfiler->record("replot", QLatin1String("replot"), profilerStart, mProfiler->now());
+    mProfiler->endFrame();
+  }
   
 # if QT_VERSION < QT_VERSION_CHECK(4, 8, 0)
   mReplotTime = replotTimer.elapsed();
@@ -15176,6 +17151,40 @@ double QCustomPlot::replotTime(bool average) const
   return average ? mReplotTimeAverage : mReplotTime;
 }
 
+/*!
+  Forces the next \ref replot to redraw all layers, even if the plotting hint \ref
+  QCP::phSkipStaticLayers is set and the axis ranges didn't change.
+
+  QCustomPlot detects changes of the viewport, the axis rect geometry, the axis ranges, scale types
+  and selection states by itself. Call this method after changing other properties of layerables
+  that don't hold plottables or items, e.g. axis labels, pens, the tick count or the grid, while
+  \ref QCP::phSkipStaticLayers is active.
+
+  \see replot, setPlottingHints
+*/
+void QCustomPlot::invalidateStaticLayers()
+{
+  mStaticLayersValid = false;
+}
+
+/*!
+  Forces the next \ref replot to run all layout passes, even if the plotting hint \ref
+  QCP::phSkipLayout is set and the layout appears unchanged.
+
+  QCustomPlot detects changes of the viewport, the structure of the layout tree, the size
+  constraints and margins of layout elements, the axis margins (axis labels, tick label extents,
+  paddings and offsets), the texts and fonts of text elements and legend items, and the inset
+  placements by itself. Call this method after changing other properties which influence the size
+  hints of layout elements, e.g. of custom QCPLayoutElement subclasses, while \ref
+  QCP::phSkipLayout is active.
+
+  \see replot, setPlottingHints
+*/
+void QCustomPlot::invalidateLayout()
+{
+  mLayoutValid = false;
+}
+
 /*!
   Rescales the axes such that all plottables (like graphs) in the plot are fully visible.
   
@@ -15254,6 +17263,7 @@ bool QCustomPlot::savePdf(const QString &fileName, int width, int height, QCP::E
     newHeight = height;
   }
   
+  QMutexLocker plotLocker(mRenderThread ? mRenderThread->plotMutex() : nullptr); // see setAsyncRendering
   QPrinter printer(QPrinter::ScreenResolution);
   printer.setOutputFileName(fileName);
   printer.setOutputFormat(QPrinter::PdfFormat);
@@ -15462,6 +17472,9 @@ QSize QCustomPlot::sizeHint() const
   
   Event handler for when the QCustomPlot widget needs repainting. This does not cause a \ref replot, but
   draws the internal buffer on the widget surface.
+
+  If asynchronous rendering is enabled (\ref setAsyncRendering), only the most recent frame
+  finished by the render thread is drawn.
 */
 void QCustomPlot::paintEvent(QPaintEvent *event)
 {
@@ -15472,11 +17485,25 @@ void QCustomPlot::paintEvent(QPaintEvent *event)
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
   painter.setRenderHint(QPainter::HighQualityAntialiasing); // to make Antialiasing look good if using the OpenGL graphicssystem
 #endif
-    if (mBackgroundBrush.style() != Qt::NoBrush)
-      painter.fillRect(mViewport, mBackgroundBrush);
-    drawBackground(&painter);
-    foreach (QSharedPointer<QCPAbstractPaintBuffer> buffer, mPaintBuffers)
-      buffer->draw(&painter);
+    {
+      QCPProfileScope paintScope(mProfiler, "paint", QLatin1String("paintEvent"));
+      if (mRenderThread)
+      {
+        if (!mRenderThread->drawFrame(&painter) && mBackgroundBrush.style() != Qt::NoBrush) // no frame finished yet
+          painter.fillRect(rect(), mBackgroundBrush);
+      } else
+      {
+        if (mBackgroundBrush.style() != Qt::NoBrush)
+          painter.fillRect(mViewport, mBackgroundBrush);
+        drawBackground(&painter);
+        foreach (QSharedPointer<QCPAbstractPaintBuffer> buffer, mPaintBuffers)
+          buffer->draw(&painter);
+        if (!mInteractionSnapshot.isNull()) // axis ranges changed by user interaction since the last replot
+          drawInteractionSnapshot(&painter);
+      }
+    }
+    if (mProfiler && mProfiler->overlayVisible())
+      mProfiler->drawOverlay(&painter, mViewport);
   }
 }
 
@@ -15488,6 +17515,7 @@ void QCustomPlot::paintEvent(QPaintEvent *event)
 void QCustomPlot::resizeEvent(QResizeEvent *event)
 {
   Q_UNUSED(event)
+  QMutexLocker plotLocker(mRenderThread ? mRenderThread->plotMutex() : nullptr); // see setAsyncRendering
   // resize and repaint the buffer:
   setViewport(rect());
   replot(rpQueuedRefresh); // queued refresh is important here, to prevent painting issues in some contexts (e.g. MDI subwindow)
@@ -15504,6 +17532,7 @@ void QCustomPlot::resizeEvent(QResizeEvent *event)
 */
 void QCustomPlot::mouseDoubleClickEvent(QMouseEvent *event)
 {
+  QMutexLocker plotLocker(mRenderThread ? mRenderThread->plotMutex() : nullptr); // see setAsyncRendering
   emit mouseDoubleClick(event);
   mMouseHasMoved = false;
   mMousePressPos = event->pos();
@@ -15556,6 +17585,7 @@ void QCustomPlot::mouseDoubleClickEvent(QMouseEvent *event)
 */
 void QCustomPlot::mousePressEvent(QMouseEvent *event)
 {
+  QMutexLocker plotLocker(mRenderThread ? mRenderThread->plotMutex() : nullptr); // see setAsyncRendering
   emit mousePress(event);
   // save some state to tell in releaseEvent whether it was a click:
   mMouseHasMoved = false;
@@ -15606,6 +17636,7 @@ void QCustomPlot::mousePressEvent(QMouseEvent *event)
 */
 void QCustomPlot::mouseMoveEvent(QMouseEvent *event)
 {
+  QMutexLocker plotLocker(mRenderThread ? mRenderThread->plotMutex() : nullptr); // see setAsyncRendering
   emit mouseMove(event);
   
   if (!mMouseHasMoved && (mMousePressPos-event->pos()).manhattanLength() > 3)
@@ -15635,6 +17666,7 @@ void QCustomPlot::mouseMoveEvent(QMouseEvent *event)
 */
 void QCustomPlot::mouseReleaseEvent(QMouseEvent *event)
 {
+  QMutexLocker plotLocker(mRenderThread ? mRenderThread->plotMutex() : nullptr); // see setAsyncRendering
   emit mouseRelease(event);
   
   if (!mMouseHasMoved) // mouse hasn't moved (much) between press and release, so handle as click
@@ -15689,6 +17721,7 @@ void QCustomPlot::mouseReleaseEvent(QMouseEvent *event)
 */
 void QCustomPlot::wheelEvent(QWheelEvent *event)
 {
+  QMutexLocker plotLocker(mRenderThread ? mRenderThread->plotMutex() : nullptr); // see setAsyncRendering
   emit mouseWheel(event);
   
 #if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
@@ -15721,6 +17754,9 @@ void QCustomPlot::wheelEvent(QWheelEvent *event)
 void QCustomPlot::draw(QCPPainter *painter)
 {
   updateLayout();
+  QList<QCPGraph*> preparedGraphs;
+  if (mPlottingHints.testFlag(QCP::phParallelGeometry))
+    preparedGraphs = prepareGraphGeometry(mLayers);
   
   // draw viewport background pixmap:
   drawBackground(painter);
@@ -15728,6 +17764,7 @@ void QCustomPlot::draw(QCPPainter *painter)
   // draw all layered objects (grid, axes, plottables, items, legend,...):
   foreach (QCPLayer *layer, mLayers)
     layer->draw(painter);
+  discardGraphGeometry(preparedGraphs);
   
   /* Debug code to draw all layout element rects
   foreach (QCPLayoutElement *el, findChildren<QCPLayoutElement*>())
@@ -15748,13 +17785,25 @@ void QCustomPlot::draw(QCPPainter *painter)
 
   Here, the layout elements calculate their positions and margins, and prepare for the following
   draw call.
+
+  If the plotting hint \ref QCP::phSkipLayout is set, only the preparation phase (which e.g.
+  generates the axis ticks for the current ranges) is run when the \ref layoutState didn't change
+  since the last layout, and the margin and layout phases are skipped.
 */
 void QCustomPlot::updateLayout()
 {
+  QCPProfileScope layoutScope(mProfiler, "layout", QLatin1String("updateLayout"));
   // run through layout phases:
   mPlotLayout->update(QCPLayoutElement::upPreparation);
-  mPlotLayout->update(QCPLayoutElement::upMargins);
-  mPlotLayout->update(QCPLayoutElement::upLayout);
+  const bool skipLayout = mPlottingHints.testFlag(QCP::phSkipLayout);
+  if (!skipLayout || !mLayoutValid || layoutState() != mLayoutState)
+  {
+    mPlotLayout->update(QCPLayoutElement::upMargins);
+    mPlotLayout->update(QCPLayoutElement::upLayout);
+    // the margins and axis offsets are results of the layout passes, so take the reference state afterwards:
+    mLayoutState = skipLayout ? layoutState() : QVector<double>();
+    mLayoutValid = skipLayout;
+  }
 
   emit afterLayout();
 }
@@ -15766,11 +17815,16 @@ void QCustomPlot::updateLayout()
   If a pixmap was provided via \ref setBackground, this function buffers the scaled version
   depending on \ref setBackgroundScaled and \ref setBackgroundScaledMode and then draws it inside
   the viewport with the provided \a painter. The scaled version is buffered in
-  mScaledBackgroundPixmap to prevent expensive rescaling at every redraw. It is only updated, when
+  mScaledBackgroundImage to prevent expensive rescaling at every redraw. It is only updated, when
   the axis rect has changed in a way that requires a rescale of the background pixmap (this is
   dependent on the \ref setBackgroundScaledMode), or when a differend axis background pixmap was
   set.
   
+  The background pixmap is kept as a QImage copy (converted in \ref setBackground), and it is
+  scaled and drawn as QImage. This is also the case for the backgrounds of axis rects and polar
+  axes, because with \ref setAsyncRendering this function runs in the render thread, where QPixmaps
+  must not be created.
+  
   Note that this function does not draw a fill with the background brush
   (\ref setBackground(const QBrush &brush)) beneath the pixmap.
   
@@ -15781,19 +17835,19 @@ void QCustomPlot::drawBackground(QCPPainter *painter)
   // Note: background color is handled in individual replot/save functions
 
   // draw background pixmap (on top of fill, if brush specified):
-  if (!mBackgroundPixmap.isNull())
+  if (!mBackgroundImage.isNull())
   {
     if (mBackgroundScaled)
     {
       // check whether mScaledBackground needs to be updated:
-      QSize scaledSize(mBackgroundPixmap.size());
+      QSize scaledSize(mBackgroundImage.size());
       scaledSize.scale(mViewport.size(), mBackgroundScaledMode);
-      if (mScaledBackgroundPixmap.size() != scaledSize)
-        mScaledBackgroundPixmap = mBackgroundPixmap.scaled(mViewport.size(), mBackgroundScaledMode, Qt::SmoothTransformation);
-      painter->drawPixmap(mViewport.topLeft(), mScaledBackgroundPixmap, QRect(0, 0, mViewport.width(), mViewport.height()) & mScaledBackgroundPixmap.rect());
+      if (mScaledBackgroundImage.size() != scaledSize)
+        mScaledBackgroundImage = mBackgroundImage.scaled(mViewport.size(), mBackgroundScaledMode, Qt::SmoothTransformation);
+      painter->drawImage(mViewport.topLeft(), mScaledBackgroundImage, QRect(0, 0, mViewport.width(), mViewport.height()) & mScaledBackgroundImage.rect());
     } else
     {
-      painter->drawPixmap(mViewport.topLeft(), mBackgroundPixmap, QRect(0, 0, mViewport.width(), mViewport.height()));
+      painter->drawImage(mViewport.topLeft(), mBackgroundImage, QRect(0, 0, mViewport.width(), mViewport.height()));
     }
   }
 }
@@ -15810,8 +17864,10 @@ void QCustomPlot::drawBackground(QCPPainter *painter)
 
   This method uses \ref createPaintBuffer to create new paint buffers.
 
-  After this method, the paint buffers are empty (filled with \c Qt::transparent) and invalidated
-  (so an attempt to replot only a single buffered layer causes a full replot).
+  Paint buffers that were newly created, reallocated or whose layer association has changed are
+  invalidated (so an attempt to replot only a single buffered layer causes a full replot). Clearing
+  the buffers is left to \ref replot, which may keep the contents of buffers that don't need to be
+  redrawn (see \ref QCP::phSkipStaticLayers).
 
   This method is called in every \ref replot call, prior to actually drawing the layers (into their
   associated paint buffer). If the paint buffers don't need changing/reallocating, this method
@@ -15826,15 +17882,16 @@ void QCustomPlot::setupPaintBuffers()
   for (int layerIndex = 0; layerIndex < mLayers.size(); ++layerIndex)
   {
     QCPLayer *layer = mLayers.at(layerIndex);
+    QSharedPointer<QCPAbstractPaintBuffer> layerBuffer;
     if (layer->mode() == QCPLayer::lmLogical)
     {
-      layer->mPaintBuffer = mPaintBuffers.at(bufferIndex).toWeakRef();
+      layerBuffer = mPaintBuffers.at(bufferIndex);
     } else if (layer->mode() == QCPLayer::lmBuffered)
     {
       ++bufferIndex;
       if (bufferIndex >= mPaintBuffers.size())
         mPaintBuffers.append(QSharedPointer<QCPAbstractPaintBuffer>(createPaintBuffer()));
-      layer->mPaintBuffer = mPaintBuffers.at(bufferIndex).toWeakRef();
+      layerBuffer = mPaintBuffers.at(bufferIndex);
       if (layerIndex < mLayers.size()-1 && mLayers.at(layerIndex+1)->mode() == QCPLayer::lmLogical) // not last layer, and next one is logical, so prepare another buffer for next layerables
       {
         ++bufferIndex;
@@ -15842,26 +17899,27 @@ void QCustomPlot::setupPaintBuffers()
           mPaintBuffers.append(QSharedPointer<QCPAbstractPaintBuffer>(createPaintBuffer()));
       }
     }
+    if (layer->mPaintBuffer.toStrongRef() != layerBuffer) // layer association changed, so contents of target buffer are outdated
+    {
+      layer->mPaintBuffer = layerBuffer.toWeakRef();
+      layerBuffer->setInvalidated();
+    }
   }
   // remove unneeded buffers:
   while (mPaintBuffers.size()-1 > bufferIndex)
     mPaintBuffers.removeLast();
-  // resize buffers to viewport size and clear contents:
+  // resize buffers to viewport size (reallocation invalidates the buffer):
   foreach (QSharedPointer<QCPAbstractPaintBuffer> buffer, mPaintBuffers)
-  {
     buffer->setSize(viewport().size()); // won't do anything if already correct size
-    buffer->clear(Qt::transparent);
-    buffer->setInvalidated();
-  }
 }
 
 /*! \internal
 
   This method is used by \ref setupPaintBuffers when it needs to create new paint buffers.
 
-  Depending on the current setting of \ref setOpenGl, and the current Qt version, different
-  backends (subclasses of \ref QCPAbstractPaintBuffer) are created, initialized with the proper
-  size and device pixel ratio, and returned.
+  Depending on the current setting of \ref setOpenGl, \ref setParallelRasterization, the plotting
+  hint \ref QCP::phRasterizeLines and the current Qt version, different backends (subclasses of \ref QCPAbstractPaintBuffer) are created,
+  initialized with the proper size and device pixel ratio, and returned.
 */
 QCPAbstractPaintBuffer *QCustomPlot::createPaintBuffer()
 {
@@ -15875,7 +17933,9 @@ QCPAbstractPaintBuffer *QCustomPlot::createPaintBuffer()
     qDebug() << Q_FUNC_INFO << "OpenGL enabled even though no support for it compiled in, this shouldn't have happened. Falling back to pixmap paint buffer.";
     return new QCPPaintBufferPixmap(viewport().size(), mBufferDevicePixelRatio);
 #endif
-  } else
+  } else if (mParallelRasterization || mPlottingHints.testFlag(QCP::phRasterizeLines))
+    return new QCPPaintBufferImage(viewport().size(), mBufferDevicePixelRatio);
+  else
     return new QCPPaintBufferPixmap(viewport().size(), mBufferDevicePixelRatio);
 }
 
@@ -15900,6 +17960,401 @@ bool QCustomPlot::hasInvalidatedPaintBuffers()
   return false;
 }
 
+/*! \internal
+
+  Returns a flat list of all properties which, when changed, require the layers without plottables
+  or items to be redrawn: the viewport, the buffer device pixel ratio, the antialiasing overrides,
+  the geometry of each axis rect and the range, scale type, orientation and selection state of each
+  axis.
+
+  \ref replot compares this state with the one of the previous replot to decide whether it may skip
+  the static layers, if \ref QCP::phSkipStaticLayers is set.
+*/
+QVector<double> QCustomPlot::staticLayerState() const
+{
+  QVector<double> result;
+  result << mViewport.x() << mViewport.y() << mViewport.width() << mViewport.height() << mBufferDevicePixelRatio
+         << static_cast<int>(mAntialiasedElements) << static_cast<int>(mNotAntialiasedElements);
+  foreach (QCPAxisRect *axisRect, axisRects())
+  {
+    const QRect rect = axisRect->rect();
+    result << rect.x() << rect.y() << rect.width() << rect.height();
+    foreach (QCPAxis *axis, axisRect->axes())
+    {
+      result << axis->range().lower << axis->range().upper << axis->scaleType() << axis->rangeReversed()
+             << static_cast<int>(axis->selectedParts());
+    }
+  }
+  return result;
+}
+
+/*! \internal
+
+  Returns a flat list of all properties which, when changed, require the margin and layout passes
+  of \ref updateLayout: the viewport, and for every element of the layout tree its identity,
+  visibility, size constraints, margins and margin groups. Axis rects contribute the margin of
+  each axis, layout grids their spacings and stretch factors, inset layouts the placement of their
+  elements, and text elements, legends and legend items their texts and fonts.
+
+  The axis margins are taken from \ref QCPAxis::calculateMargin, which only measures the axis
+  again if its label or tick labels changed. This makes the state cheap to compute for frames
+  where only data or axis ranges changed.
+
+  \ref updateLayout compares this state with the one after the previous layout, to decide whether
+  it may skip the layout passes, if \ref QCP::phSkipLayout is set.
+*/
+QVector<double> QCustomPlot::layoutState()
+{
+  QVector<double> result;
+  result << mViewport.x() << mViewport.y() << mViewport.width() << mViewport.height();
+  QList<QCPLayoutElement*> elements = mPlotLayout->elements(true);
+  elements.prepend(mPlotLayout);
+  foreach (QCPLayoutElement *element, elements)
+  {
+    result << double(reinterpret_cast<quintptr>(element));
+    if (!element) // empty cell of a layout grid
+      continue;
+    const QMargins margins = element->margins();
+    const QMargins minimumMargins = element->minimumMargins();
+    result << element->visible() << element->sizeConstraintRect() << static_cast<int>(element->autoMargins())
+           << element->minimumSize().width() << element->minimumSize().height()
+           << element->maximumSize().width() << element->maximumSize().height()
+           << margins.left() << margins.right() << margins.top() << margins.bottom()
+           << minimumMargins.left() << minimumMargins.right() << minimumMargins.top() << minimumMargins.bottom()
+           << double(reinterpret_cast<quintptr>(element->marginGroup(QCP::msLeft))) << double(reinterpret_cast<quintptr>(element->marginGroup(QCP::msRight)))
+           << double(reinterpret_cast<quintptr>(element->marginGroup(QCP::msTop))) << double(reinterpret_cast<quintptr>(element->marginGroup(QCP::msBottom)));
+    
+    if (QCPAxisRect *axisRect = qobject_cast<QCPAxisRect*>(element))
+    {
+      foreach (QCPAxis *axis, axisRect->axes())
+        result << double(reinterpret_cast<quintptr>(axis)) << axis->offset() << axis->calculateMargin();
+    } else if (QCPLayoutGrid *grid = qobject_cast<QCPLayoutGrid*>(element))
+    {
+      result << grid->rowCount() << grid->columnCount() << grid->rowSpacing() << grid->columnSpacing();
+      foreach (double factor, grid->rowStretchFactors())
+        result << factor;
+      foreach (double factor, grid->columnStretchFactors())
+        result << factor;
+      if (QCPLegend *legend = qobject_cast<QCPLegend*>(grid))
+        result << legend->iconSize().width() << legend->iconSize().height() << legend->iconTextPadding() << double(qHash(legend->font().key()));
+    } else if (QCPLayoutInset *inset = qobject_cast<QCPLayoutInset*>(element))
+    {
+      for (int i=0; i<inset->elementCount(); ++i)
+      {
+        const QRectF rect = inset->insetRect(i);
+        result << inset->insetPlacement(i) << static_cast<int>(inset->insetAlignment(i))
+               << rect.x() << rect.y() << rect.width() << rect.height();
+      }
+    } else if (QCPTextElement *textElement = qobject_cast<QCPTextElement*>(element))
+    {
+      result << double(qHash(textElement->text())) << double(qHash(textElement->font().key()));
+    } else if (QCPAbstractLegendItem *legendItem = qobject_cast<QCPAbstractLegendItem*>(element))
+    {
+      result << double(qHash(legendItem->font().key()));
+      if (QCPPlottableLegendItem *plottableItem = qobject_cast<QCPPlottableLegendItem*>(legendItem))
+        result << double(qHash(plottableItem->plottable()->name()));
+    } else if (QCPColorScale *colorScale = qobject_cast<QCPColorScale*>(element))
+    {
+      result << colorScale->type() << colorScale->barWidth();
+      if (colorScale->axis())
+        result << colorScale->axis()->calculateMargin();
+    }
+  }
+  return result;
+}
+
+/*! \internal
+
+  Draws the layers associated with the provided paint \a buffers, like \ref
+  QCPLayer::drawToPaintBuffer would, but distributes the work onto the raster thread pool (see \ref
+  setParallelRasterization). Returns once all buffers are drawn.
+
+  Each buffer becomes one \ref QCPRasterJob. If the visible layerables of a buffer are clipped to
+  mutually disjoint rects (and the device pixel ratio is integral, so the rects map to whole device
+  pixels), one job per clip rect is created instead, each painting onto a \ref
+  QCPPaintBufferImage::subImage. Since the regions are disjoint, the rendering order between those
+  jobs doesn't matter. Buffers that aren't \ref QCPPaintBufferImage instances are drawn serially.
+*/
+void QCustomPlot::drawPaintBuffersParallel(const QList<QCPAbstractPaintBuffer*> &buffers)
+{
+  foreach (QCPAbstractPaintBuffer *buffer, buffers)
+  {
+    QCPPaintBufferImage *imageBuffer = dynamic_cast<QCPPaintBufferImage*>(buffer);
+    if (!imageBuffer)
+    {
+      foreach (QCPLayer *layer, mLayers)
+      {
+        if (layer->mPaintBuffer.toStrongRef().data() == buffer)
+          layer->drawToPaintBuffer();
+      }
+      continue;
+    }
+    
+    // collect visible layerables of this buffer in rendering order and group them by clip rect:
+    QList<QCPLayerable*> layerables;
+    QList<QRect> regions;
+    QList<QList<QCPLayerable*> > regionLayerables;
+    foreach (QCPLayer *layer, mLayers)
+    {
+      if (layer->mPaintBuffer.toStrongRef().data() != buffer)
+        continue;
+      foreach (QCPLayerable *child, layer->children())
+      {
+        if (!child->realVisibility())
+          continue;
+        layerables.append(child);
+        const QRect region = child->clipRect().translated(0, -1); // same clip as in QCPLayer::draw
+        int regionIndex = regions.indexOf(region);
+        if (regionIndex < 0)
+        {
+          regions.append(region);
+          regionLayerables.append(QList<QCPLayerable*>());
+          regionIndex = regions.size()-1;
+        }
+        regionLayerables[regionIndex].append(child);
+      }
+    }
+    
+    const double ratio = imageBuffer->devicePixelRatio();
+    bool splitRegions = regions.size() > 1 && qFuzzyCompare(ratio, double(qRound(ratio)));
+    for (int i=0; i<regions.size() && splitRegions; ++i)
+    {
+      for (int k=i+1; k<regions.size() && splitRegions; ++k)
+        splitRegions = !regions.at(i).intersects(regions.at(k));
+    }
+    
+    if (splitRegions)
+    {
+      const int intRatio = qRound(ratio);
+      for (int i=0; i<regions.size(); ++i)
+      {
+        const QRect deviceRect = QRect(regions.at(i).topLeft()*intRatio, regions.at(i).size()*intRatio) & imageBuffer->image().rect();
+        if (deviceRect.isEmpty())
+          continue;
+        mRasterThreadPool->start(new QCPRasterJob(imageBuffer->subImage(deviceRect), deviceRect.topLeft()/intRatio, regionLayerables.at(i)));
+      }
+    } else if (!layerables.isEmpty())
+      mRasterThreadPool->start(new QCPRasterJob(imageBuffer->subImage(imageBuffer->image().rect()), QPoint(0, 0), layerables));
+  }
+  mRasterThreadPool->waitForDone();
+}
+
+/*! \internal
+
+  Computes the pixel geometry of all visible graphs on the given \a layers concurrently on the
+  raster thread pool, by running a \ref QCPGraphGeometryJob for each of them. Returns once all
+  jobs are finished. Drawing the graphs afterwards only strokes the prepared geometry (see \ref
+  QCPGraph::prepareGeometry).
+
+  Returns the graphs whose geometry was prepared. Pass them to \ref discardGraphGeometry after
+  drawing, so no stale geometry remains in graphs that weren't drawn.
+
+  This is used for the plotting hint \ref QCP::phParallelGeometry.
+*/
+QList<QCPGraph*> QCustomPlot::prepareGraphGeometry(const QList<QCPLayer*> &layers)
+{
+  QList<QCPGraph*> graphs;
+  if (!mRasterThreadPool)
+    return graphs;
+  foreach (QCPLayer *layer, layers)
+  {
+    foreach (QCPLayerable *child, layer->children())
+    {
+      QCPGraph *graph = qobject_cast<QCPGraph*>(child);
+      if (graph && graph->realVisibility())
+        graphs.append(graph);
+    }
+  }
+  if (graphs.size() < 2) // a single graph gains nothing from a separate phase
+  {
+    graphs.clear();
+    return graphs;
+  }
+  
+  QCPProfileScope profileScope(mProfiler, "geometry", QLatin1String("prepareGraphGeometry"));
+  foreach (QCPGraph *graph, graphs)
+    mRasterThreadPool->start(new QCPGraphGeometryJob(graph));
+  mRasterThreadPool->waitForDone();
+  return graphs;
+}
+
+/*! \internal
+
+  Releases the geometry that \ref prepareGraphGeometry computed for \a graphs and that wasn't
+  consumed by drawing.
+*/
+void QCustomPlot::discardGraphGeometry(const QList<QCPGraph*> &graphs)
+{
+  foreach (QCPGraph *graph, graphs)
+    graph->discardGeometry();
+}
+
+/*! \internal
+
+  Called by the range drag and zoom interactions of \a axisRect and its axes, after they changed the
+  axis ranges. If the plotting hint \ref QCP::phProgressiveInteraction isn't set (or asynchronous
+  rendering or OpenGL is used), this just calls \ref replot with \a refreshPriority.
+
+  Otherwise, the current contents of \a axisRect are taken as snapshot (if not done since the last
+  replot), and the widget is repainted right away. \ref paintEvent then draws the snapshot shifted
+  and scaled to the new axis ranges (see \ref drawInteractionSnapshot). A coarse replot is
+  scheduled, unless one is pending already, and the full replot is postponed until the input was
+  idle for \ref setProgressiveRefineDelay milliseconds.
+*/
+void QCustomPlot::interactionReplot(QCPAxisRect *axisRect, QCustomPlot::RefreshPriority refreshPriority)
+{
+  if (!mPlottingHints.testFlag(QCP::phProgressiveInteraction) || mRenderThread || mOpenGl || !axisRect)
+  {
+    replot(refreshPriority);
+    return;
+  }
+  
+  if (mInteractionSnapshot.isNull() || mInteractionAxisRect != axisRect)
+  {
+    mInteractionAxisRect = axisRect;
+    mInteractionSnapshot = axisRectSnapshot(axisRect);
+  }
+  if (!mCoarseReplotTimer->isActive()) // throttled, so coarse replots don't block the event loop permanently
+    mCoarseReplotTimer->start();
+  mRefineReplotTimer->start(mProgressiveRefineDelay); // restarts, so the full replot only happens after input is idle
+  if (mPlottingHints.testFlag(QCP::phImmediateRefresh))
+    repaint();
+  else
+    update();
+}
+
+/*! \internal
+
+  Replots with antialiasing disabled and graphs reduced to a coarse level of detail, as part of
+  progressive interaction (\ref QCP::phProgressiveInteraction). Afterwards, the interval until the
+  next coarse replot is set to twice the time this replot took, but at least 16 milliseconds, so
+  at most a third of the time is spent in coarse replots and the remaining input events still get
+  their immediate snapshot feedback.
+
+  \see refineReplot
+*/
+void QCustomPlot::coarseReplot()
+{
+  const QCP::AntialiasedElements antialiasedBackup = mAntialiasedElements;
+  const QCP::AntialiasedElements notAntialiasedBackup = mNotAntialiasedElements;
+  mAntialiasedElements = QCP::aeNone;
+  mNotAntialiasedElements = QCP::aeAll;
+  mCoarseReplot = true;
+  replot(rpRefreshHint);
+  mCoarseReplot = false;
+  mAntialiasedElements = antialiasedBackup;
+  mNotAntialiasedElements = notAntialiasedBackup;
+  mCoarseReplotTimer->setInterval(qBound(16, qRound(2*mReplotTime), 1000));
+}
+
+/*! \internal
+
+  Replots in full detail once the input of a progressive interaction (\ref
+  QCP::phProgressiveInteraction) was idle for \ref setProgressiveRefineDelay milliseconds.
+
+  \see coarseReplot
+*/
+void QCustomPlot::refineReplot()
+{
+  mCoarseReplotTimer->stop();
+  invalidateStaticLayers(); // the static layers of coarse replots were drawn without antialiasing
+  replot(rpRefreshHint);
+}
+
+/*! \internal
+
+  Remembers the ranges of all axes at the time of the replot, so \ref drawInteractionSnapshot can
+  tell how the ranges changed since the paint buffers were drawn.
+*/
+void QCustomPlot::recordRenderedRanges()
+{
+  mRenderedAxes.clear();
+  mRenderedRanges.clear();
+  foreach (QCPAxisRect *axisRect, axisRects())
+  {
+    foreach (QCPAxis *axis, axisRect->axes())
+    {
+      mRenderedAxes.append(axis);
+      mRenderedRanges.append(axis->range());
+    }
+  }
+}
+
+/*! \internal
+
+  Returns the contents of the paint buffers inside the rect of \a axisRect, as a pixmap with the
+  device pixel ratio of the paint buffers. Used as snapshot of the last replot during progressive
+  interaction.
+*/
+QPixmap QCustomPlot::axisRectSnapshot(QCPAxisRect *axisRect)
+{
+  const QRect rect = axisRect->rect();
+  QPixmap result(rect.size()*mBufferDevicePixelRatio);
+#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
+  result.setDevicePixelRatio(mBufferDevicePixelRatio);
+#endif
+  result.fill(Qt::transparent);
+  QCPPainter painter(&result);
+  painter.translate(-rect.topLeft());
+  foreach (QSharedPointer<QCPAbstractPaintBuffer> buffer, mPaintBuffers)
+    buffer->draw(&painter);
+  return result;
+}
+
+/*! \internal
+
+  Draws the snapshot of the interacting axis rect (see \ref interactionReplot) with \a painter,
+  transformed such that it matches the current axis ranges. For each orientation, the first axis of
+  the axis rect whose range differs from the one of the last replot determines the transform. Since
+  the mapping between two ranges of the same axis is linear in pixels (also for logarithmic axes),
+  the transform is a plain scale and translation.
+
+  Everything in the snapshot moves along, including items and an inset legend, until the next
+  coarse replot redraws them at their proper positions.
+*/
+void QCustomPlot::drawInteractionSnapshot(QCPPainter *painter)
+{
+  QCPAxisRect *axisRect = mInteractionAxisRect.data();
+  if (!axisRect)
+    return;
+  const QRect rect = axisRect->rect();
+  QRectF target(rect);
+  bool horizontalMapped = false, verticalMapped = false;
+  foreach (QCPAxis *axis, axisRect->axes())
+  {
+    const bool horizontal = axis->orientation() == Qt::Horizontal;
+    const int index = mRenderedAxes.indexOf(axis);
+    if ((horizontal ? horizontalMapped : verticalMapped) || index < 0 || mRenderedRanges.at(index) == axis->range())
+      continue;
+    // the current range bounds are at the pixels where the rendered range bounds were, when the snapshot was taken:
+    const double oldLower = axis->coordToPixel(axis->range().lower);
+    const double oldUpper = axis->coordToPixel(axis->range().upper);
+    const double newLower = axis->coordToPixel(mRenderedRanges.at(index).lower);
+    const double newUpper = axis->coordToPixel(mRenderedRanges.at(index).upper);
+    if (qIsNaN(newLower) || qIsNaN(newUpper) || qFuzzyCompare(oldLower, oldUpper))
+      continue;
+    const double scale = (newUpper-newLower)/(oldUpper-oldLower);
+    if (horizontal)
+    {
+      target.setLeft(newLower+(rect.left()-oldLower)*scale);
+      target.setRight(newLower+(rect.left()+rect.width()-oldLower)*scale);
+      horizontalMapped = true;
+    } else
+    {
+      target.setTop(newLower+(rect.top()-oldLower)*scale);
+      target.setBottom(newLower+(rect.top()+rect.height()-oldLower)*scale);
+      verticalMapped = true;
+    }
+  }
+  
+  painter->save();
+  painter->setClipRect(rect);
+  if (mBackgroundBrush.style() != Qt::NoBrush)
+    painter->fillRect(rect, mBackgroundBrush);
+  painter->drawPixmap(target, mInteractionSnapshot, QRectF(mInteractionSnapshot.rect()));
+  painter->restore();
+}
+
 /*! \internal
 
   When \ref setOpenGl is set to true, this method is used to initialize OpenGL (create a context,
@@ -16098,6 +18553,7 @@ void QCustomPlot::processRectSelection(QRect rect, QMouseEvent *event)
   
   if (selectionStateChanged)
   {
+    invalidateStaticLayers(); // e.g. legend items may have changed their selection state
     emit selectionChangedByUser();
     replot(rpQueuedReplot);
   } else if (mSelectionRect)
@@ -16175,6 +18631,7 @@ void QCustomPlot::processPointSelection(QMouseEvent *event)
   }
   if (selectionStateChanged)
   {
+    invalidateStaticLayers(); // e.g. legend items may have changed their selection state
     emit selectionChangedByUser();
     replot(rpQueuedReplot);
   }
@@ -16358,6 +18815,9 @@ QList<QCPLayerable*> QCustomPlot::layerableListAt(const QPointF &pos, bool onlyS
   Returns true on success. If this function fails, most likely the given \a format isn't supported
   by the system, see Qt docs about QImageWriter::supportedImageFormats().
 
+  Since the plot is rendered with \ref toImage, this function may also be called outside the GUI
+  thread, as long as the plot isn't accessed concurrently (see \ref QCPBatchRenderer).
+
   The \a resolution will be written to the image file header (if the file format supports this) and
   has no direct consequence for the quality or the pixel size. However, if opening the image with a
   tool which respects the metadata, it will be able to scale the image to match either a given size
@@ -16369,7 +18829,7 @@ QList<QCPLayerable*> QCustomPlot::layerableListAt(const QPointF &pos, bool onlyS
 */
 bool QCustomPlot::saveRastered(const QString &fileName, int width, int height, double scale, const char *format, int quality, int resolution, QCP::ResolutionUnit resolutionUnit)
 {
-  QImage buffer = toPixmap(width, height, scale).toImage();
+  QImage buffer = toImage(width, height, scale);
   
   int dotsPerMeter = 0;
   switch (resolutionUnit)
@@ -16392,7 +18852,7 @@ bool QCustomPlot::saveRastered(const QString &fileName, int width, int height, d
   The plot is sized to \a width and \a height in pixels and scaled with \a scale. (width 100 and
   scale 2.0 lead to a full resolution pixmap with width 200.)
   
-  \see toPainter, saveRastered, saveBmp, savePng, saveJpg, savePdf
+  \see toImage, toPainter, saveRastered, saveBmp, savePng, saveJpg, savePdf
 */
 QPixmap QCustomPlot::toPixmap(int width, int height, double scale)
 {
@@ -16409,6 +18869,7 @@ QPixmap QCustomPlot::toPixmap(int width, int height, double scale)
   }
   int scaledWidth = qRound(scale*newWidth);
   int scaledHeight = qRound(scale*newHeight);
+  QMutexLocker plotLocker(mRenderThread ? mRenderThread->plotMutex() : nullptr); // see setAsyncRendering
 
   QPixmap result(scaledWidth, scaledHeight);
   result.fill(mBackgroundBrush.style() == Qt::SolidPattern ? mBackgroundBrush.color() : Qt::transparent); // if using non-solid pattern, make transparent now and draw brush pattern later
@@ -16438,6 +18899,64 @@ QPixmap QCustomPlot::toPixmap(int width, int height, double scale)
   return result;
 }
 
+/*!
+  Renders the plot to an image and returns it.
+  
+  The plot is sized to \a width and \a height in pixels and scaled with \a scale. (width 100 and
+  scale 2.0 lead to a full resolution image with width 200.)
+
+  Unlike \ref toPixmap, this function doesn't create any QPixmap as long as no background pixmap is
+  set (\ref setBackground), so it may be called outside the GUI thread, e.g. to export plots of a
+  QCustomPlot that is never shown. The plot must not be accessed concurrently by other threads
+  meanwhile.
+  
+  \see toPixmap, toPainter, saveRastered
+*/
+QImage QCustomPlot::toImage(int width, int height, double scale)
+{
+  // this method is somewhat similar to toPixmap. Change something here, and a change in toPixmap might be necessary, too.
+  int newWidth, newHeight;
+  if (width == 0 || height == 0)
+  {
+    newWidth = this->width();
+    newHeight = this->height();
+  } else
+  {
+    newWidth = width;
+    newHeight = height;
+  }
+  int scaledWidth = qRound(scale*newWidth);
+  int scaledHeight = qRound(scale*newHeight);
+  QMutexLocker plotLocker(mRenderThread ? mRenderThread->plotMutex() : nullptr); // see setAsyncRendering
+
+  QImage result(scaledWidth, scaledHeight, QImage::Format_ARGB32_Premultiplied);
+  result.fill(mBackgroundBrush.style() == Qt::SolidPattern ? mBackgroundBrush.color() : QColor(Qt::transparent)); // if using non-solid pattern, make transparent now and draw brush pattern later
+  QCPPainter painter;
+  painter.begin(&result);
+  if (painter.isActive())
+  {
+    QRect oldViewport = viewport();
+    setViewport(QRect(0, 0, newWidth, newHeight));
+    painter.setMode(QCPPainter::pmNoCaching);
+    if (!qFuzzyCompare(scale, 1.0))
+    {
+      if (scale > 1.0) // for scale < 1 we always want cosmetic pens where possible, because else lines might disappear for very small scales
+        painter.setMode(QCPPainter::pmNonCosmetic);
+      painter.scale(scale, scale);
+    }
+    if (mBackgroundBrush.style() != Qt::SolidPattern && mBackgroundBrush.style() != Qt::NoBrush) // solid fills were done a few lines above with QImage::fill
+      painter.fillRect(mViewport, mBackgroundBrush);
+    draw(&painter);
+    setViewport(oldViewport);
+    painter.end();
+  } else // might happen if image has width or height zero
+  {
+    qDebug() << Q_FUNC_INFO << "Couldn't activate painter on image";
+    return QImage();
+  }
+  return result;
+}
+
 /*!
   Renders the plot using the passed \a painter.
   
@@ -16466,6 +18985,7 @@ void QCustomPlot::toPainter(QCPPainter *painter, int width, int height)
 
   if (painter->isActive())
   {
+    QMutexLocker plotLocker(mRenderThread ? mRenderThread->plotMutex() : nullptr); // see setAsyncRendering
     QRect oldViewport = viewport();
     setViewport(QRect(0, 0, newWidth, newHeight));
     painter->setMode(QCPPainter::pmNoCaching);
@@ -16703,34 +19223,25 @@ void QCPColorGradient::colorize(const double *data, const QCPRange &range, QRgb
   if (mColorBufferInvalidated)
     updateColorBuffer();
   
+  const QRgb *colorBuffer = mColorBuffer.constData(); // const access, so concurrent calls on a shared gradient never detach
   const bool skipNanCheck = mNanHandling == nhNone;
-  const double posToIndexFactor = !logarithmic ? (mLevelCount-1)/range.size() : (mLevelCount-1)/qLn(range.upper/range.lower);
-  for (int i=0; i<n; ++i)
-  {
-    const double value = data[dataIndexFactor*i];
-    if (skipNanCheck || !std::isnan(value))
-    {
-      int index = int((!logarithmic ? value-range.lower : qLn(value/range.lower)) * posToIndexFactor);
-      if (!mPeriodic)
-      {
-        index = qBound(0, index, mLevelCount-1);
-      } else
-      {
-        index %= mLevelCount;
-        if (index < 0)
-          index += mLevelCount;
-      }
-      scanLine[i] = mColorBuffer.at(index);
+  const QRgb nanColor = nanRgb();
+  const int blockSize = 256; // values are processed in blocks: first mapped to color indices, then looked up
+  int indices[blockSize];
+  for (int blockStart=0; blockStart<n; blockStart+=blockSize)
+  {
+    const int blockCount = qMin(blockSize, n-blockStart);
+    const double *blockData = data+dataIndexFactor*blockStart;
+    QRgb *blockLine = scanLine+blockStart;
+    colorIndices(blockData, range, indices, blockCount, dataIndexFactor, logarithmic);
+    if (skipNanCheck)
+    {
+      for (int i=0; i<blockCount; ++i)
+        blockLine[i] = colorBuffer[indices[i]];
     } else
     {
-      switch(mNanHandling)
-      {
-      case nhLowestColor: scanLine[i] = mColorBuffer.first(); break;
-      case nhHighestColor: scanLine[i] = mColorBuffer.last(); break;
-      case nhTransparent: scanLine[i] = qRgba(0, 0, 0, 0); break;
-      case nhNanColor: scanLine[i] = mNanColor.rgba(); break;
-      case nhNone: break; // shouldn't happen
-      }
+      for (int i=0; i<blockCount; ++i)
+        blockLine[i] = std::isnan(blockData[dataIndexFactor*i]) ? nanColor : colorBuffer[indices[i]];
     }
   }
 }
@@ -16764,41 +19275,31 @@ void QCPColorGradient::colorize(const double *data, const unsigned char *alpha,
   if (mColorBufferInvalidated)
     updateColorBuffer();
   
+  const QRgb *colorBuffer = mColorBuffer.constData(); // const access, so concurrent calls on a shared gradient never detach
   const bool skipNanCheck = mNanHandling == nhNone;
-  const double posToIndexFactor = !logarithmic ? (mLevelCount-1)/range.size() : (mLevelCount-1)/qLn(range.upper/range.lower);
-  for (int i=0; i<n; ++i)
-  {
-    const double value = data[dataIndexFactor*i];
-    if (skipNanCheck || !std::isnan(value))
-    {
-      int index = int((!logarithmic ? value-range.lower : qLn(value/range.lower)) * posToIndexFactor);
-      if (!mPeriodic)
-      {
-        index = qBound(0, index, mLevelCount-1);
-      } else
+  const QRgb nanColor = nanRgb();
+  const int blockSize = 256; // values are processed in blocks: first mapped to color indices, then looked up
+  int indices[blockSize];
+  for (int blockStart=0; blockStart<n; blockStart+=blockSize)
+  {
+    const int blockCount = qMin(blockSize, n-blockStart);
+    const double *blockData = data+dataIndexFactor*blockStart;
+    const unsigned char *blockAlpha = alpha+dataIndexFactor*blockStart;
+    QRgb *blockLine = scanLine+blockStart;
+    colorIndices(blockData, range, indices, blockCount, dataIndexFactor, logarithmic);
+    for (int i=0; i<blockCount; ++i)
+    {
+      if (!skipNanCheck && std::isnan(blockData[dataIndexFactor*i]))
       {
-        index %= mLevelCount;
-        if (index < 0)
-          index += mLevelCount;
-      }
-      if (alpha[dataIndexFactor*i] == 255)
+        blockLine[i] = nanColor;
+      } else if (blockAlpha[dataIndexFactor*i] == 255)
       {
-        scanLine[i] = mColorBuffer.at(index);
+        blockLine[i] = colorBuffer[indices[i]];
       } else
       {
-        const QRgb rgb = mColorBuffer.at(index);
-        const float alphaF = alpha[dataIndexFactor*i]/255.0f;
-        scanLine[i] = qRgba(int(qRed(rgb)*alphaF), int(qGreen(rgb)*alphaF), int(qBlue(rgb)*alphaF), int(qAlpha(rgb)*alphaF)); // also multiply r,g,b with alpha, to conform to Format_ARGB32_Premultiplied
-      }
-    } else
-    {
-      switch(mNanHandling)
-      {
-      case nhLowestColor: scanLine[i] = mColorBuffer.first(); break;
-      case nhHighestColor: scanLine[i] = mColorBuffer.last(); break;
-      case nhTransparent: scanLine[i] = qRgba(0, 0, 0, 0); break;
-      case nhNanColor: scanLine[i] = mNanColor.rgba(); break;
-      case nhNone: break; // shouldn't happen
+        const QRgb rgb = colorBuffer[indices[i]];
+        const float alphaF = blockAlpha[dataIndexFactor*i]/255.0f;
+        blockLine[i] = qRgba(int(qRed(rgb)*alphaF), int(qGreen(rgb)*alphaF), int(qBlue(rgb)*alphaF), int(qAlpha(rgb)*alphaF)); // also multiply r,g,b with alpha, to conform to Format_ARGB32_Premultiplied
       }
     }
   }
@@ -17111,6 +19612,66 @@ void QCPColorGradient::updateColorBuffer()
   }
   mColorBufferInvalidated = false;
 }
+
+/*! \internal
+  
+  Maps the \a n values in \a data (spaced by \a dataIndexFactor) to indices into the color buffer
+  and writes them to \a indices. This is the first stage of \ref colorize, kept free of branches
+  and table lookups in the common non-periodic case, so the compiler can vectorize it.
+  
+  Clamping is done in floating point before the integer conversion. For all values whose index
+  the previous integer clamping defined, this yields the identical index, while out-of-range and
+  NaN values now map to a valid index instead of overflowing the integer conversion. NaN values
+  are replaced with the NaN color by the caller anyway (unless the NaN handling is \ref nhNone).
+*/
+void QCPColorGradient::colorIndices(const double *data, const QCPRange &range, int *indices, int n, int dataIndexFactor, bool logarithmic) const
+{
+  // If you change something here, make sure to also adapt color()
+  const double lower = range.lower;
+  const double posToIndexFactor = !logarithmic ? (mLevelCount-1)/range.size() : (mLevelCount-1)/qLn(range.upper/range.lower);
+  if (!mPeriodic)
+  {
+    const double maxIndex = mLevelCount-1;
+    if (!logarithmic)
+    {
+      for (int i=0; i<n; ++i)
+        indices[i] = int(qBound(0.0, (data[dataIndexFactor*i]-lower)*posToIndexFactor, maxIndex));
+    } else
+    {
+      for (int i=0; i<n; ++i)
+        indices[i] = int(qBound(0.0, qLn(data[dataIndexFactor*i]/lower)*posToIndexFactor, maxIndex));
+    }
+  } else
+  {
+    for (int i=0; i<n; ++i)
+    {
+      const double value = data[dataIndexFactor*i];
+      const double position = (!logarithmic ? value-lower : qLn(value/lower))*posToIndexFactor;
+      int index = std::isfinite(position) ? int(std::fmod(position, double(mLevelCount))) : 0;
+      if (index < 0)
+        index += mLevelCount;
+      indices[i] = index;
+    }
+  }
+}
+
+/*! \internal
+  
+  Returns the color that NaN data values are mapped to according to the current NaN handling (see
+  \ref setNanHandling). Requires an up-to-date color buffer.
+*/
+QRgb QCPColorGradient::nanRgb() const
+{
+  switch (mNanHandling)
+  {
+    case nhLowestColor: return mColorBuffer.first();
+    case nhHighestColor: return mColorBuffer.last();
+    case nhTransparent: return qRgba(0, 0, 0, 0);
+    case nhNanColor: return mNanColor.rgba();
+    case nhNone: break;
+  }
+  return qRgba(0, 0, 0, 0);
+}
 /* end of 'src/colorgradient.cpp' */
 
 
@@ -18036,7 +20597,8 @@ void QCPAxisRect::draw(QCPPainter *painter)
 void QCPAxisRect::setBackground(const QPixmap &pm)
 {
   mBackgroundPixmap = pm;
-  mScaledBackgroundPixmap = QPixmap();
+  mBackgroundImage = pm.toImage();
+  mScaledBackgroundImage = QImage();
 }
 
 /*! \overload
@@ -18067,7 +20629,8 @@ void QCPAxisRect::setBackground(const QBrush &brush)
 void QCPAxisRect::setBackground(const QPixmap &pm, bool scaled, Qt::AspectRatioMode mode)
 {
   mBackgroundPixmap = pm;
-  mScaledBackgroundPixmap = QPixmap();
+  mBackgroundImage = pm.toImage();
+  mScaledBackgroundImage = QImage();
   mBackgroundScaled = scaled;
   mBackgroundScaledMode = mode;
 }
@@ -18408,7 +20971,7 @@ void QCPAxisRect::setRangeZoomFactor(double factor)
   Then, if a pixmap was provided via \ref setBackground, this function buffers the scaled version
   depending on \ref setBackgroundScaled and \ref setBackgroundScaledMode and then draws it inside
   the axis rect with the provided \a painter. The scaled version is buffered in
-  mScaledBackgroundPixmap to prevent expensive rescaling at every redraw. It is only updated, when
+  mScaledBackgroundImage to prevent expensive rescaling at every redraw. It is only updated, when
   the axis rect has changed in a way that requires a rescale of the background pixmap (this is
   dependent on the \ref setBackgroundScaledMode), or when a differend axis background pixmap was
   set.
@@ -18422,19 +20985,19 @@ void QCPAxisRect::drawBackground(QCPPainter *painter)
     painter->fillRect(mRect, mBackgroundBrush);
   
   // draw background pixmap (on top of fill, if brush specified):
-  if (!mBackgroundPixmap.isNull())
+  if (!mBackgroundImage.isNull())
   {
     if (mBackgroundScaled)
     {
       // check whether mScaledBackground needs to be updated:
-      QSize scaledSize(mBackgroundPixmap.size());
+      QSize scaledSize(mBackgroundImage.size());
       scaledSize.scale(mRect.size(), mBackgroundScaledMode);
-      if (mScaledBackgroundPixmap.size() != scaledSize)
-        mScaledBackgroundPixmap = mBackgroundPixmap.scaled(mRect.size(), mBackgroundScaledMode, Qt::SmoothTransformation);
-      painter->drawPixmap(mRect.topLeft()+QPoint(0, -1), mScaledBackgroundPixmap, QRect(0, 0, mRect.width(), mRect.height()) & mScaledBackgroundPixmap.rect());
+      if (mScaledBackgroundImage.size() != scaledSize)
+        mScaledBackgroundImage = mBackgroundImage.scaled(mRect.size(), mBackgroundScaledMode, Qt::SmoothTransformation);
+      painter->drawImage(mRect.topLeft()+QPoint(0, -1), mScaledBackgroundImage, QRect(0, 0, mRect.width(), mRect.height()) & mScaledBackgroundImage.rect());
     } else
     {
-      painter->drawPixmap(mRect.topLeft()+QPoint(0, -1), mBackgroundPixmap, QRect(0, 0, mRect.width(), mRect.height()));
+      painter->drawImage(mRect.topLeft()+QPoint(0, -1), mBackgroundImage, QRect(0, 0, mRect.width(), mRect.height()));
     }
   }
 }
@@ -18606,7 +21169,7 @@ void QCPAxisRect::mouseMoveEvent(QMouseEvent *event, const QPointF &startPos)
     {
       if (mParentPlot->noAntialiasingOnDrag())
         mParentPlot->setNotAntialiasedElements(QCP::aeAll);
-      mParentPlot->replot(QCustomPlot::rpQueuedReplot);
+      mParentPlot->interactionReplot(this, QCustomPlot::rpQueuedReplot);
     }
     
   }
@@ -18678,7 +21241,7 @@ void QCPAxisRect::wheelEvent(QWheelEvent *event)
             axis->scaleRange(factor, axis->pixelToCoord(pos.y()));
         }
       }
-      mParentPlot->replot();
+      mParentPlot->interactionReplot(this, QCustomPlot::rpRefreshHint);
     }
   }
 }
@@ -20717,6 +23280,23 @@ void QCPColorScaleAxisRectPrivate::axisSelectableChanged(QCPAxis::SelectablePart
   \ref QCPDataContainer with \ref QCPGraphData as the DataType template parameter. See the
   documentation there for an explanation regarding the data type's generic methods.
   
+  By default, key and value are doubles, taking 16 bytes per data point. For long histories of
+  measurements with limited resolution, the storage precision can be reduced at compile time, which
+  halves the memory and the bandwidth of the data scans during replots:
+  \li With \c QCP_SINGLE_PRECISION_DATA defined, key and value are floats. This is only suitable if
+  the keys have few significant digits, e.g. seconds since the start of a measurement. Timestamps
+  in seconds since epoch would be resolved in steps of 128 s.
+  \li With \c QCP_OFFSET_KEY_DATA defined, the value is a float, and the key is a float offset from
+  an application-wide double base (see \ref QCPOffsetKey), which suits timestamps since epoch. Set
+  the base with \c QCPOffsetKey<float>::setBase before adding data. Keys stay below 10 ms
+  resolution only within about 18 hours of the base, see \ref QCPOffsetKey for the limits.
+  
+  Both are build-wide switches, affecting all graphs and curves of the application alike (see \ref
+  QCPDataKey).
+  
+  Since the members convert to double wherever they are read, all algorithms of \ref QCPGraph,
+  \ref QCPDataContainer and \ref QCPAbstractPlottable1D work with either precision.
+  
   \see QCPGraphDataContainer
 */
 
@@ -20861,7 +23441,9 @@ QCPGraph::QCPGraph(QCPAxis *keyAxis, QCPAxis *valueAxis) :
   QCPAbstractPlottable1D<QCPGraphData>(keyAxis, valueAxis),
   mLineStyle{},
   mScatterSkip{},
-  mAdaptiveSampling{}
+  mAdaptiveSampling{},
+  mGeometryPrepared(false),
+  mPreparedUnselectedCount(0)
 {
   // special handling for QCPGraphs to maintain the simple graph interface:
   mParentPlot->registerGraph(this);
@@ -20965,6 +23547,7 @@ void QCPGraph::setScatterSkip(int skip)
 */
 void QCPGraph::setChannelFillGraph(QCPGraph *targetGraph)
 {
+  mChannelFillSignature.clear(); // invalidates channel fill cache
   // prevent setting channel target to this graph itself:
   if (targetGraph == this)
   {
@@ -21116,12 +23699,17 @@ void QCPGraph::draw(QCPPainter *painter)
   QList<QCPDataRange> selectedSegments, unselectedSegments, allSegments;
   getDataSegments(selectedSegments, unselectedSegments);
   allSegments << unselectedSegments << selectedSegments;
+  // use the geometry of prepareGeometry, if it was computed for the same segments:
+  const bool usePreparedGeometry = mGeometryPrepared && mPreparedUnselectedCount == unselectedSegments.size() && mPreparedSegments == allSegments;
   for (int i=0; i<allSegments.size(); ++i)
   {
     bool isSelectedSegment = i >= unselectedSegments.size();
     // get line pixel points appropriate to line style:
     QCPDataRange lineDataRange = isSelectedSegment ? allSegments.at(i) : allSegments.at(i).adjusted(-1, 1); // unselected segments extend lines to bordering selected data point (safe to exceed total data bounds in first/last segment, getLines takes care)
-    getLines(&lines, lineDataRange);
+    if (usePreparedGeometry)
+      lines = mPreparedLines.at(i);
+    else
+      getLines(&lines, lineDataRange);
     
     // check data validity if flag set:
 #ifdef QCUSTOMPLOT_CHECK_DATA
@@ -21161,10 +23749,14 @@ void QCPGraph::draw(QCPPainter *painter)
       finalScatterStyle = mSelectionDecorator->getFinalScatterStyle(mScatterStyle);
     if (!finalScatterStyle.isNone())
     {
-      getScatters(&scatters, allSegments.at(i));
+      if (usePreparedGeometry)
+        scatters = mPreparedScatters.at(i);
+      else
+        getScatters(&scatters, allSegments.at(i));
       drawScatterPlot(painter, scatters, finalScatterStyle);
     }
   }
+  discardGeometry(); // prepared geometry is only valid for the replot it was prepared for
   
   // draw other selection decoration that isn't just line/scatter pens and brushes:
   if (mSelectionDecorator)
@@ -21266,6 +23858,10 @@ void QCPGraph::getLines(QVector<QPointF> *lines, const QCPDataRange &dataRange)
   a correspondingly trimmed data range will be used. This takes the burden off the user of this
   function to check for valid indices in \a dataRange, e.g. when extending ranges coming from \ref
   getDataSegments.
+  
+  If adaptive sampling is enabled (\ref setAdaptiveSampling) and the scatter symbols are opaque,
+  scatters that fall on the same device pixel as a later one are removed, see \ref
+  removeCoincidentScatters.
 */
 void QCPGraph::getScatters(QVector<QPointF> *scatters, const QCPDataRange &dataRange) const
 {
@@ -21289,27 +23885,90 @@ void QCPGraph::getScatters(QVector<QPointF> *scatters, const QCPDataRange &dataR
     std::reverse(data.begin(), data.end());
   
   scatters->resize(data.size());
-  if (keyAxis->orientation() == Qt::Vertical)
+  QVector<double> keyPixels, valuePixels;
+  dataToPixels(data, &keyPixels, &valuePixels);
+  const double *x = keyAxis->orientation() == Qt::Vertical ? valuePixels.constData() : keyPixels.constData();
+  const double *y = keyAxis->orientation() == Qt::Vertical ? keyPixels.constData() : valuePixels.constData();
+  for (int i=0; i<data.size(); ++i)
   {
-    for (int i=0; i<data.size(); ++i)
-    {
-      if (!qIsNaN(data.at(i).value))
-      {
-        (*scatters)[i].setX(valueAxis->coordToPixel(data.at(i).value));
-        (*scatters)[i].setY(keyAxis->coordToPixel(data.at(i).key));
-      }
-    }
-  } else
+    if (!qIsNaN(data.at(i).value))
+      (*scatters)[i] = QPointF(x[i], y[i]);
+  }
+  
+  if (mAdaptiveSampling && scatters->size() > 1 && mScatterStyle.isOpaque(mPen) &&
+      (!mSelectionDecorator || mSelectionDecorator->getFinalScatterStyle(mScatterStyle).isOpaque(mPen)))
+    removeCoincidentScatters(scatters);
+}
+
+/*! \internal
+
+  Removes the scatters in \a scatters (given in pixel coordinates) whose symbol would be drawn over
+  by a later symbol centered on the same device pixel, and drops scatters with NaN coordinates. The
+  order of the remaining scatters is kept, and their positions are not modified.
+
+  This is only applied to opaque symbols (see \ref QCPScatterStyle::isOpaque), where the later
+  symbol covers all pixels of the earlier ones. So dense scatter plots only draw about as many
+  symbols as there are device pixels in the data cloud, independently of antialiasing and the
+  plotting hints. Without antialiasing, the result is identical. With antialiasing, the removed
+  symbols were offset from the kept one by less than a device pixel, so the antialiased edge of the
+  kept symbol may show up to one device pixel less partial coverage than the overlapping symbols
+  would have produced.
+*/
+void QCPGraph::removeCoincidentScatters(QVector<QPointF> *scatters) const
+{
+  const double ratio = mParentPlot->bufferDevicePixelRatio();
+  const int count = scatters->size();
+  QVector<qint64> pixelKeys(count);
+  QHash<qint64, int> lastIndex;
+  lastIndex.reserve(count);
+  for (int i=0; i<count; ++i)
   {
-    for (int i=0; i<data.size(); ++i)
+    const QPointF &pos = scatters->at(i);
+    if (qIsNaN(pos.x()) || qIsNaN(pos.y()))
     {
-      if (!qIsNaN(data.at(i).value))
-      {
-        (*scatters)[i].setX(keyAxis->coordToPixel(data.at(i).key));
-        (*scatters)[i].setY(valueAxis->coordToPixel(data.at(i).value));
-      }
+      pixelKeys[i] = -1;
+      continue;
     }
+    // far off-screen scatters may share a clamped key, that's harmless since they aren't visible:
+    const qint64 px = qint64(qFloor(qBound(-1e9, pos.x()*ratio, 1e9))) & 0xFFFFFFFF;
+    const qint64 py = qint64(qFloor(qBound(-1e9, pos.y()*ratio, 1e9))) & 0x7FFFFFFF;
+    pixelKeys[i] = (py << 32) | px;
+    lastIndex.insert(pixelKeys.at(i), i);
+  }
+  
+  int kept = 0;
+  for (int i=0; i<count; ++i)
+  {
+    if (pixelKeys.at(i) >= 0 && lastIndex.value(pixelKeys.at(i)) == i)
+      (*scatters)[kept++] = scatters->at(i);
   }
+  scatters->resize(kept);
+}
+
+/*! \internal
+
+  Transforms the keys and values of \a data to pixel coordinates along the key and value axis,
+  respectively, and returns them in \a keyPixels and \a valuePixels.
+
+  The coordinates are gathered into contiguous arrays first, so each axis maps its whole array in
+  one call to \ref QCPAxis::coordsToPixels instead of resolving its orientation, scale type and
+  range direction again for every data point. This is the common first step of the line and
+  scatter builders (\ref dataToLines, \ref getScatters, etc.).
+*/
+void QCPGraph::dataToPixels(const QVector<QCPGraphData> &data, QVector<double> *keyPixels, QVector<double> *valuePixels) const
+{
+  const int count = data.size();
+  keyPixels->resize(count);
+  valuePixels->resize(count);
+  double *keys = keyPixels->data();
+  double *values = valuePixels->data();
+  for (int i=0; i<count; ++i)
+  {
+    keys[i] = data.at(i).key;
+    values[i] = data.at(i).value;
+  }
+  mKeyAxis.data()->coordsToPixels(keys, keys, count);
+  mValueAxis.data()->coordsToPixels(values, values, count);
 }
 
 /*! \internal
@@ -21332,21 +23991,12 @@ QVector<QPointF> QCPGraph::dataToLines(const QVector<QCPGraphData> &data) const
   result.resize(data.size());
   
   // transform data points to pixels:
-  if (keyAxis->orientation() == Qt::Vertical)
-  {
-    for (int i=0; i<data.size(); ++i)
-    {
-      result[i].setX(valueAxis->coordToPixel(data.at(i).value));
-      result[i].setY(keyAxis->coordToPixel(data.at(i).key));
-    }
-  } else // key axis is horizontal
-  {
-    for (int i=0; i<data.size(); ++i)
-    {
-      result[i].setX(keyAxis->coordToPixel(data.at(i).key));
-      result[i].setY(valueAxis->coordToPixel(data.at(i).value));
-    }
-  }
+  QVector<double> keyPixels, valuePixels;
+  dataToPixels(data, &keyPixels, &valuePixels);
+  const double *x = keyAxis->orientation() == Qt::Vertical ? valuePixels.constData() : keyPixels.constData();
+  const double *y = keyAxis->orientation() == Qt::Vertical ? keyPixels.constData() : valuePixels.constData();
+  for (int i=0; i<data.size(); ++i)
+    result[i] = QPointF(x[i], y[i]);
   return result;
 }
 
@@ -21370,27 +24020,29 @@ QVector<QPointF> QCPGraph::dataToStepLeftLines(const QVector<QCPGraphData> &data
   result.resize(data.size()*2);
   
   // calculate steps from data and transform to pixel coordinates:
+  QVector<double> keyPixels, valuePixels;
+  dataToPixels(data, &keyPixels, &valuePixels);
   if (keyAxis->orientation() == Qt::Vertical)
   {
-    double lastValue = valueAxis->coordToPixel(data.first().value);
+    double lastValue = valuePixels.first();
     for (int i=0; i<data.size(); ++i)
     {
-      const double key = keyAxis->coordToPixel(data.at(i).key);
+      const double key = keyPixels.at(i);
       result[i*2+0].setX(lastValue);
       result[i*2+0].setY(key);
-      lastValue = valueAxis->coordToPixel(data.at(i).value);
+      lastValue = valuePixels.at(i);
       result[i*2+1].setX(lastValue);
       result[i*2+1].setY(key);
     }
   } else // key axis is horizontal
   {
-    double lastValue = valueAxis->coordToPixel(data.first().value);
+    double lastValue = valuePixels.first();
     for (int i=0; i<data.size(); ++i)
     {
-      const double key = keyAxis->coordToPixel(data.at(i).key);
+      const double key = keyPixels.at(i);
       result[i*2+0].setX(key);
       result[i*2+0].setY(lastValue);
-      lastValue = valueAxis->coordToPixel(data.at(i).value);
+      lastValue = valuePixels.at(i);
       result[i*2+1].setX(key);
       result[i*2+1].setY(lastValue);
     }
@@ -21418,27 +24070,29 @@ QVector<QPointF> QCPGraph::dataToStepRightLines(const QVector<QCPGraphData> &dat
   result.resize(data.size()*2);
   
   // calculate steps from data and transform to pixel coordinates:
+  QVector<double> keyPixels, valuePixels;
+  dataToPixels(data, &keyPixels, &valuePixels);
   if (keyAxis->orientation() == Qt::Vertical)
   {
-    double lastKey = keyAxis->coordToPixel(data.first().key);
+    double lastKey = keyPixels.first();
     for (int i=0; i<data.size(); ++i)
     {
-      const double value = valueAxis->coordToPixel(data.at(i).value);
+      const double value = valuePixels.at(i);
       result[i*2+0].setX(value);
       result[i*2+0].setY(lastKey);
-      lastKey = keyAxis->coordToPixel(data.at(i).key);
+      lastKey = keyPixels.at(i);
       result[i*2+1].setX(value);
       result[i*2+1].setY(lastKey);
     }
   } else // key axis is horizontal
   {
-    double lastKey = keyAxis->coordToPixel(data.first().key);
+    double lastKey = keyPixels.first();
     for (int i=0; i<data.size(); ++i)
     {
-      const double value = valueAxis->coordToPixel(data.at(i).value);
+      const double value = valuePixels.at(i);
       result[i*2+0].setX(lastKey);
       result[i*2+0].setY(value);
-      lastKey = keyAxis->coordToPixel(data.at(i).key);
+      lastKey = keyPixels.at(i);
       result[i*2+1].setX(lastKey);
       result[i*2+1].setY(value);
     }
@@ -21466,19 +24120,21 @@ QVector<QPointF> QCPGraph::dataToStepCenterLines(const QVector<QCPGraphData> &da
   result.resize(data.size()*2);
   
   // calculate steps from data and transform to pixel coordinates:
+  QVector<double> keyPixels, valuePixels;
+  dataToPixels(data, &keyPixels, &valuePixels);
   if (keyAxis->orientation() == Qt::Vertical)
   {
-    double lastKey = keyAxis->coordToPixel(data.first().key);
-    double lastValue = valueAxis->coordToPixel(data.first().value);
+    double lastKey = keyPixels.first();
+    double lastValue = valuePixels.first();
     result[0].setX(lastValue);
     result[0].setY(lastKey);
     for (int i=1; i<data.size(); ++i)
     {
-      const double key = (keyAxis->coordToPixel(data.at(i).key)+lastKey)*0.5;
+      const double key = (keyPixels.at(i)+lastKey)*0.5;
       result[i*2-1].setX(lastValue);
       result[i*2-1].setY(key);
-      lastValue = valueAxis->coordToPixel(data.at(i).value);
-      lastKey = keyAxis->coordToPixel(data.at(i).key);
+      lastValue = valuePixels.at(i);
+      lastKey = keyPixels.at(i);
       result[i*2+0].setX(lastValue);
       result[i*2+0].setY(key);
     }
@@ -21486,17 +24142,17 @@ QVector<QPointF> QCPGraph::dataToStepCenterLines(const QVector<QCPGraphData> &da
     result[data.size()*2-1].setY(lastKey);
   } else // key axis is horizontal
   {
-    double lastKey = keyAxis->coordToPixel(data.first().key);
-    double lastValue = valueAxis->coordToPixel(data.first().value);
+    double lastKey = keyPixels.first();
+    double lastValue = valuePixels.first();
     result[0].setX(lastKey);
     result[0].setY(lastValue);
     for (int i=1; i<data.size(); ++i)
     {
-      const double key = (keyAxis->coordToPixel(data.at(i).key)+lastKey)*0.5;
+      const double key = (keyPixels.at(i)+lastKey)*0.5;
       result[i*2-1].setX(key);
       result[i*2-1].setY(lastValue);
-      lastValue = valueAxis->coordToPixel(data.at(i).value);
-      lastKey = keyAxis->coordToPixel(data.at(i).key);
+      lastValue = valuePixels.at(i);
+      lastKey = keyPixels.at(i);
       result[i*2+0].setX(key);
       result[i*2+0].setY(lastValue);
     }
@@ -21526,25 +24182,28 @@ QVector<QPointF> QCPGraph::dataToImpulseLines(const QVector<QCPGraphData> &data)
   result.resize(data.size()*2);
   
   // transform data points to pixels:
+  QVector<double> keyPixels, valuePixels;
+  dataToPixels(data, &keyPixels, &valuePixels);
+  const double zeroPixel = valueAxis->coordToPixel(0);
   if (keyAxis->orientation() == Qt::Vertical)
   {
     for (int i=0; i<data.size(); ++i)
     {
-      const double key = keyAxis->coordToPixel(data.at(i).key);
-      result[i*2+0].setX(valueAxis->coordToPixel(0));
+      const double key = keyPixels.at(i);
+      result[i*2+0].setX(zeroPixel);
       result[i*2+0].setY(key);
-      result[i*2+1].setX(valueAxis->coordToPixel(data.at(i).value));
+      result[i*2+1].setX(valuePixels.at(i));
       result[i*2+1].setY(key);
     }
   } else // key axis is horizontal
   {
     for (int i=0; i<data.size(); ++i)
     {
-      const double key = keyAxis->coordToPixel(data.at(i).key);
+      const double key = keyPixels.at(i);
       result[i*2+0].setX(key);
-      result[i*2+0].setY(valueAxis->coordToPixel(0));
+      result[i*2+0].setY(zeroPixel);
       result[i*2+1].setX(key);
-      result[i*2+1].setY(valueAxis->coordToPixel(data.at(i).value));
+      result[i*2+1].setY(valuePixels.at(i));
     }
   }
   return result;
@@ -21563,6 +24222,12 @@ QVector<QPointF> QCPGraph::dataToImpulseLines(const QVector<QCPGraphData> &data)
   segments of the two involved graphs, before passing the overlapping pairs to \ref
   getChannelFillPolygon.
   
+  The lines of the channel fill graph and the channel fill polygons are cached. The lines are only
+  regenerated when the channel fill graph's data, line style or axes change (see \ref
+  getChannelFillSignature), and the polygons only when additionally \a lines differ from the
+  previous call. So replots that don't affect the two graphs (e.g. of other layers or items) don't
+  rebuild the channel fill.
+  
   Pass the points of this graph's line as \a lines, in pixel coordinates.
 
   \see drawLinePlot, drawImpulsePlot, drawScatterPlot
@@ -21573,24 +24238,38 @@ void QCPGraph::drawFill(QCPPainter *painter, QVector<QPointF> *lines) const
   if (painter->brush().style() == Qt::NoBrush || painter->brush().color().alpha() == 0) return;
   
   applyFillAntialiasingHint(painter);
-  const QVector<QCPDataRange> segments = getNonNanSegments(lines, keyAxis()->orientation());
   if (!mChannelFillGraph)
   {
     // draw base fill under graph, fill goes all the way to the zero-value-line:
+    const QVector<QCPDataRange> segments = getNonNanSegments(lines, keyAxis()->orientation());
     foreach (QCPDataRange segment, segments)
       painter->drawPolygon(getFillPolygon(lines, segment));
   } else
   {
-    // draw fill between this graph and mChannelFillGraph:
-    QVector<QPointF> otherLines;
-    mChannelFillGraph->getLines(&otherLines, QCPDataRange(0, mChannelFillGraph->dataCount()));
-    if (!otherLines.isEmpty())
+    // draw fill between this graph and mChannelFillGraph, regenerate cached lines and polygons if necessary:
+    const QVector<double> signature = getChannelFillSignature();
+    if (signature != mChannelFillSignature)
+    {
+      mChannelFillGraph->getLines(&mChannelFillOtherLines, QCPDataRange(0, mChannelFillGraph->dataCount()));
+      mChannelFillOtherSegments = getNonNanSegments(&mChannelFillOtherLines, mChannelFillGraph->keyAxis()->orientation());
+      mChannelFillSignature = signature;
+      mChannelFillLines.clear();
+      mChannelFillPolygons.clear();
+    }
+    if (*lines != mChannelFillLines)
     {
-      QVector<QCPDataRange> otherSegments = getNonNanSegments(&otherLines, mChannelFillGraph->keyAxis()->orientation());
-      QVector<QPair<QCPDataRange, QCPDataRange> > segmentPairs = getOverlappingSegments(segments, lines, otherSegments, &otherLines);
-      for (int i=0; i<segmentPairs.size(); ++i)
-        painter->drawPolygon(getChannelFillPolygon(lines, segmentPairs.at(i).first, &otherLines, segmentPairs.at(i).second));
+      mChannelFillPolygons.clear();
+      if (!mChannelFillOtherLines.isEmpty())
+      {
+        const QVector<QCPDataRange> segments = getNonNanSegments(lines, keyAxis()->orientation());
+        QVector<QPair<QCPDataRange, QCPDataRange> > segmentPairs = getOverlappingSegments(segments, lines, mChannelFillOtherSegments, &mChannelFillOtherLines);
+        for (int i=0; i<segmentPairs.size(); ++i)
+          mChannelFillPolygons.append(getChannelFillPolygon(lines, segmentPairs.at(i).first, &mChannelFillOtherLines, segmentPairs.at(i).second));
+      }
+      mChannelFillLines = *lines;
     }
+    foreach (const QPolygonF &polygon, mChannelFillPolygons)
+      painter->drawPolygon(polygon);
   }
 }
 
@@ -21605,8 +24284,7 @@ void QCPGraph::drawScatterPlot(QCPPainter *painter, const QVector<QPointF> &scat
 {
   applyScattersAntialiasingHint(painter);
   style.applyTo(painter, mPen);
-  foreach (const QPointF &scatter, scatters)
-    style.drawShape(painter, scatter.x(), scatter.y());
+  style.drawShapes(painter, scatters, scatterSpriteCache(painter));
 }
 
 /*!  \internal
@@ -21656,6 +24334,10 @@ void QCPGraph::drawImpulsePlot(QCPPainter *painter, const QVector<QPointF> &line
 
   This method is used by \ref getLines to retrieve the basic working set of data.
 
+  During the coarse replots of progressive interaction (\ref QCP::phProgressiveInteraction), data
+  with at least four points per pixel is just thinned out to every n-th point instead, so the cost
+  is bounded by the pixel span of the data rather than its size.
+
   \see getOptimizedScatterData
 */
 void QCPGraph::getOptimizedLineData(QVector<QCPGraphData> *lineData, const QCPGraphDataContainer::const_iterator &begin, const QCPGraphDataContainer::const_iterator &end) const
@@ -21675,6 +24357,18 @@ void QCPGraph::getOptimizedLineData(QVector<QCPGraphData> *lineData, const QCPGr
       maxCount = int(2*keyPixelSpan+2);
   }
   
+  if (mAdaptiveSampling && mParentPlot->mCoarseReplot && dataCount >= 2*maxCount) // coarse replot of progressive interaction, see QCP::phProgressiveInteraction
+  {
+    // only take every n-th point, so the cost is bounded by the pixel span instead of the data count:
+    const int stride = dataCount/maxCount;
+    lineData->reserve(dataCount/stride+2);
+    for (int i=0; i<dataCount; i+=stride)
+      lineData->append(*(begin+i));
+    if ((dataCount-1)%stride != 0) // make line reach the last point
+      lineData->append(*(end-1));
+    return;
+  }
+  
   if (mAdaptiveSampling && dataCount >= maxCount) // use adaptive sampling only if there are at least two points per pixel on average
   {
     QCPGraphDataContainer::const_iterator it = begin;
@@ -21775,6 +24469,16 @@ void QCPGraph::getOptimizedScatterData(QVector<QCPGraphData> *scatterData, QCPGr
     maxCount = 2*keyPixelSpan+2;
   }
   
+  if (mAdaptiveSampling && mParentPlot->mCoarseReplot && dataCount >= 2*maxCount) // coarse replot of progressive interaction, see QCP::phProgressiveInteraction
+  {
+    // only take every n-th point (a multiple of scatterModulo, so skipped scatters stay skipped):
+    const int stride = (dataCount/maxCount+scatterModulo-1)/scatterModulo*scatterModulo;
+    scatterData->reserve(dataCount/stride+1);
+    for (int i=0; i<dataCount; i+=stride)
+      scatterData->append(*(begin+i));
+    return;
+  }
+  
   if (mAdaptiveSampling && dataCount >= maxCount) // use adaptive sampling only if there are at least two points per pixel on average
   {
     double valueMaxRange = valueAxis->range().upper;
@@ -22201,6 +24905,9 @@ const QPolygonF QCPGraph::getFillPolygon(const QVector<QPointF> *lineData, QCPDa
   \ref getOverlappingSegments, to make sure only segments that actually have key coordinate overlap
   need to be processed here.
   
+  The polygon is built in a single pass over both segments without intermediate copies, the
+  overlap bounds are found with binary search (see \ref appendChannelFillPoints).
+  
   For increased performance due to implicit sharing, keep the returned QPolygonF const.
   
   \see drawFill, getOverlappingSegments, getNonNanSegments
@@ -22218,90 +24925,101 @@ const QPolygonF QCPGraph::getChannelFillPolygon(const QVector<QPointF> *thisData
   if (mChannelFillGraph.data()->mKeyAxis.data()->orientation() != keyAxis->orientation())
     return QPolygonF(); // don't have same axis orientation, can't fill that (Note: if keyAxis fits, valueAxis will fit too, because it's always orthogonal to keyAxis)
   
-  if (thisData->isEmpty()) return QPolygonF();
-  QVector<QPointF> thisSegmentData(thisSegment.size());
-  QVector<QPointF> otherSegmentData(otherSegment.size());
-  std::copy(thisData->constBegin()+thisSegment.begin(), thisData->constBegin()+thisSegment.end(), thisSegmentData.begin());
-  std::copy(otherData->constBegin()+otherSegment.begin(), otherData->constBegin()+otherSegment.end(), otherSegmentData.begin());
-  // pointers to be able to swap them, depending which data range needs cropping:
-  QVector<QPointF> *staticData = &thisSegmentData;
-  QVector<QPointF> *croppedData = &otherSegmentData;
+  if (thisData->isEmpty() || thisSegment.size() < 2 || otherSegment.size() < 2)
+    return QPolygonF();
+  
+  // key pixels are sorted ascending in both line data (see getLines), so the fill spans the overlap of the key ranges:
+  const bool keyIsX = keyAxis->orientation() == Qt::Horizontal;
+  const QPointF &thisFirst = thisData->at(thisSegment.begin());
+  const QPointF &thisLast = thisData->at(thisSegment.end()-1);
+  const QPointF &otherFirst = otherData->at(otherSegment.begin());
+  const QPointF &otherLast = otherData->at(otherSegment.end()-1);
+  const double lower = keyIsX ? qMax(thisFirst.x(), otherFirst.x()) : qMax(thisFirst.y(), otherFirst.y());
+  const double upper = keyIsX ? qMin(thisLast.x(), otherLast.x()) : qMin(thisLast.y(), otherLast.y());
+  if (!(lower < upper))
+    return QPolygonF(); // key ranges have no overlap
+  
+  QPolygonF result;
+  result.reserve(thisSegment.size()+otherSegment.size());
+  appendChannelFillPoints(result, thisData, thisSegment, lower, upper, false);
+  appendChannelFillPoints(result, otherData, otherSegment, lower, upper, true); // append reversed, otherwise the polygon will be twisted
+  return result;
+}
+
+/*! \internal
+  
+  Appends the points of \a data in \a segment to \a polygon, cropped to the key pixel range from \a
+  lower to \a upper. The first and last appended points are linearly interpolated to lie exactly
+  on \a lower and \a upper. If \a reversed is true, the points are appended in reverse order.
   
-  // crop both vectors to ranges in which the keys overlap (which coord is key, depends on axisType):
-  if (keyAxis->orientation() == Qt::Horizontal)
+  The points must be sorted ascending by key pixel, and the key pixel range of \a segment must
+  enclose \a lower and \a upper, as ensured by \ref getChannelFillPolygon.
+*/
+void QCPGraph::appendChannelFillPoints(QPolygonF &polygon, const QVector<QPointF> *data, QCPDataRange segment, double lower, double upper, bool reversed) const
+{
+  const bool keyIsX = mKeyAxis->orientation() == Qt::Horizontal;
+  const QVector<QPointF>::const_iterator begin = data->constBegin()+segment.begin();
+  const QVector<QPointF>::const_iterator end = data->constBegin()+segment.end();
+  // last point at or below lower and first point at or above upper, these get interpolated onto the bounds:
+  const QVector<QPointF>::const_iterator low = std::upper_bound(begin, end, lower, [keyIsX](double key, const QPointF &p) { return key < (keyIsX ? p.x() : p.y()); })-1;
+  const QVector<QPointF>::const_iterator high = std::lower_bound(begin, end, upper, [keyIsX](const QPointF &p, double key) { return (keyIsX ? p.x() : p.y()) < key; });
+  
+  QPointF bounds[2];
+  for (int i=0; i<2; ++i)
   {
-    // x is key
-    // crop lower bound:
-    if (staticData->first().x() < croppedData->first().x()) // other one must be cropped
-      qSwap(staticData, croppedData);
-    const int lowBound = findIndexBelowX(croppedData, staticData->first().x());
-    if (lowBound == -1) return QPolygonF(); // key ranges have no overlap
-    croppedData->remove(0, lowBound);
-    // set lowest point of cropped data to fit exactly key position of first static data point via linear interpolation:
-    if (croppedData->size() < 2) return QPolygonF(); // need at least two points for interpolation
-    double slope;
-    if (!qFuzzyCompare(croppedData->at(1).x(), croppedData->at(0).x()))
-      slope = (croppedData->at(1).y()-croppedData->at(0).y())/(croppedData->at(1).x()-croppedData->at(0).x());
-    else
-      slope = 0;
-    (*croppedData)[0].setY(croppedData->at(0).y()+slope*(staticData->first().x()-croppedData->at(0).x()));
-    (*croppedData)[0].setX(staticData->first().x());
-    
-    // crop upper bound:
-    if (staticData->last().x() > croppedData->last().x()) // other one must be cropped
-      qSwap(staticData, croppedData);
-    int highBound = findIndexAboveX(croppedData, staticData->last().x());
-    if (highBound == -1) return QPolygonF(); // key ranges have no overlap
-    croppedData->remove(highBound+1, croppedData->size()-(highBound+1));
-    // set highest point of cropped data to fit exactly key position of last static data point via linear interpolation:
-    if (croppedData->size() < 2) return QPolygonF(); // need at least two points for interpolation
-    const int li = croppedData->size()-1; // last index
-    if (!qFuzzyCompare(croppedData->at(li).x(), croppedData->at(li-1).x()))
-      slope = (croppedData->at(li).y()-croppedData->at(li-1).y())/(croppedData->at(li).x()-croppedData->at(li-1).x());
-    else
-      slope = 0;
-    (*croppedData)[li].setY(croppedData->at(li-1).y()+slope*(staticData->last().x()-croppedData->at(li-1).x()));
-    (*croppedData)[li].setX(staticData->last().x());
-  } else // mKeyAxis->orientation() == Qt::Vertical
-  {
-    // y is key
-    // crop lower bound:
-    if (staticData->first().y() < croppedData->first().y()) // other one must be cropped
-      qSwap(staticData, croppedData);
-    int lowBound = findIndexBelowY(croppedData, staticData->first().y());
-    if (lowBound == -1) return QPolygonF(); // key ranges have no overlap
-    croppedData->remove(0, lowBound);
-    // set lowest point of cropped data to fit exactly key position of first static data point via linear interpolation:
-    if (croppedData->size() < 2) return QPolygonF(); // need at least two points for interpolation
-    double slope;
-    if (!qFuzzyCompare(croppedData->at(1).y(), croppedData->at(0).y())) // avoid division by zero in step plots
-      slope = (croppedData->at(1).x()-croppedData->at(0).x())/(croppedData->at(1).y()-croppedData->at(0).y());
-    else
-      slope = 0;
-    (*croppedData)[0].setX(croppedData->at(0).x()+slope*(staticData->first().y()-croppedData->at(0).y()));
-    (*croppedData)[0].setY(staticData->first().y());
-    
-    // crop upper bound:
-    if (staticData->last().y() > croppedData->last().y()) // other one must be cropped
-      qSwap(staticData, croppedData);
-    int highBound = findIndexAboveY(croppedData, staticData->last().y());
-    if (highBound == -1) return QPolygonF(); // key ranges have no overlap
-    croppedData->remove(highBound+1, croppedData->size()-(highBound+1));
-    // set highest point of cropped data to fit exactly key position of last static data point via linear interpolation:
-    if (croppedData->size() < 2) return QPolygonF(); // need at least two points for interpolation
-    int li = croppedData->size()-1; // last index
-    if (!qFuzzyCompare(croppedData->at(li).y(), croppedData->at(li-1).y())) // avoid division by zero in step plots
-      slope = (croppedData->at(li).x()-croppedData->at(li-1).x())/(croppedData->at(li).y()-croppedData->at(li-1).y());
-    else
-      slope = 0;
-    (*croppedData)[li].setX(croppedData->at(li-1).x()+slope*(staticData->last().y()-croppedData->at(li-1).y()));
-    (*croppedData)[li].setY(staticData->last().y());
+    const QPointF &a = i == 0 ? *low : *(high-1);
+    const QPointF &b = i == 0 ? *(low+1) : *high;
+    const double key = i == 0 ? lower : upper;
+    const double aKey = keyIsX ? a.x() : a.y();
+    const double bKey = keyIsX ? b.x() : b.y();
+    const double aValue = keyIsX ? a.y() : a.x();
+    const double bValue = keyIsX ? b.y() : b.x();
+    const double slope = qFuzzyCompare(aKey, bKey) ? 0 : (bValue-aValue)/(bKey-aKey); // avoid division by zero in step plots
+    bounds[i] = keyIsX ? QPointF(key, aValue+slope*(key-aKey)) : QPointF(aValue+slope*(key-aKey), key);
   }
   
-  // return joined:
-  for (int i=otherSegmentData.size()-1; i>=0; --i) // insert reversed, otherwise the polygon will be twisted
-    thisSegmentData << otherSegmentData.at(i);
-  return QPolygonF(thisSegmentData);
+  if (!reversed)
+  {
+    polygon << bounds[0];
+    for (QVector<QPointF>::const_iterator it=low+1; it!=high; ++it)
+      polygon << *it;
+    polygon << bounds[1];
+  } else
+  {
+    polygon << bounds[1];
+    for (QVector<QPointF>::const_iterator it=high-1; it!=low; --it)
+      polygon << *it;
+    polygon << bounds[0];
+  }
+}
+
+/*! \internal
+  
+  Returns the values that determine the lines of the channel fill graph (\ref setChannelFillGraph),
+  i.e. its data revision, line style, adaptive sampling setting, the state of its axes and whether
+  the current replot is coarse (see \ref QCP::phProgressiveInteraction). \ref drawFill compares
+  them to the signature of the cached channel fill, to decide whether it must be regenerated.
+*/
+QVector<double> QCPGraph::getChannelFillSignature() const
+{
+  QVector<double> result;
+  const QCPGraph *other = mChannelFillGraph.data();
+  if (!other)
+    return result;
+  result << double(other->mDataContainer->revision()) << other->mLineStyle << other->mAdaptiveSampling << mKeyAxis->orientation() << mParentPlot->mCoarseReplot;
+  QList<QCPAxis*> axes = QList<QCPAxis*>() << other->mKeyAxis.data() << other->mValueAxis.data();
+  foreach (QCPAxis *axis, axes)
+  {
+    if (!axis)
+    {
+      result << qQNaN(); // never equal, so the cache isn't used
+      continue;
+    }
+    const QRect rect = axis->axisRect()->rect();
+    result << axis->range().lower << axis->range().upper << axis->scaleType() << axis->rangeReversed() << axis->orientation()
+           << rect.left() << rect.top() << rect.width() << rect.height();
+  }
+  return result;
 }
 
 /*! \internal
@@ -22383,6 +25101,10 @@ int QCPGraph::findIndexAboveY(const QVector<QPointF> *data, double y) const
   
   If either the graph has no data or if the line style is \ref lsNone and the scatter style's shape
   is \ref QCPScatterStyle::ssNone (i.e. there is no visual representation of the graph), returns -1.0.
+
+  Large scatter graphs (line style \ref lsNone) find the closest data point with the point index
+  (see \ref QCPAbstractPlottable1D::indexedPointDistance), since many data points may share similar
+  keys and the key range around \a pixelPoint alone doesn't narrow down the candidates enough.
 */
 double QCPGraph::pointDistance(const QPointF &pixelPoint, QCPGraphDataContainer::const_iterator &closestData) const
 {
@@ -22392,6 +25114,9 @@ double QCPGraph::pointDistance(const QPointF &pixelPoint, QCPGraphDataContainer:
   if (mLineStyle == lsNone && mScatterStyle.isNone())
     return -1.0;
   
+  if (mLineStyle == lsNone && mDataContainer->size() > 10000) // below this size, building the point index doesn't pay off
+    return indexedPointDistance(pixelPoint, closestData, false);
+  
   // calculate minimum distances to graph data points and find closestData iterator:
   double minDistSqr = (std::numeric_limits<double>::max)();
   // determine which key range comes into question, taking selection tolerance around pos into account:
@@ -22454,6 +25179,88 @@ int QCPGraph::findIndexBelowY(const QVector<QPointF> *data, double y) const
   }
   return -1;
 }
+
+/*! \internal
+
+  Computes the pixel geometry of the graph, i.e. the points that \ref getLines and \ref getScatters
+  return for every data segment that \ref draw paints, and keeps it until the next call of \ref
+  draw, which then only strokes the prepared points.
+
+  This is called concurrently for multiple graphs by \ref QCPGraphGeometryJob, if the plotting hint
+  \ref QCP::phParallelGeometry is set. Since it only reads the data and the axis state, it may run
+  in a worker thread, as long as neither is modified at the same time. The caller must make sure
+  the prepared geometry is either drawn or released with \ref discardGeometry before the graph, its
+  data or its axes change.
+*/
+void QCPGraph::prepareGeometry()
+{
+  discardGeometry();
+  if (!mKeyAxis || !mValueAxis) return;
+  if (mKeyAxis.data()->range().size() <= 0 || mDataContainer->isEmpty()) return;
+  if (mLineStyle == lsNone && mScatterStyle.isNone()) return;
+  
+  QList<QCPDataRange> selectedSegments, unselectedSegments;
+  getDataSegments(selectedSegments, unselectedSegments);
+  mPreparedSegments << unselectedSegments << selectedSegments;
+  mPreparedUnselectedCount = unselectedSegments.size();
+  mPreparedLines.resize(mPreparedSegments.size());
+  mPreparedScatters.resize(mPreparedSegments.size());
+  for (int i=0; i<mPreparedSegments.size(); ++i)
+  {
+    // same line ranges and scatter styles as in draw:
+    bool isSelectedSegment = i >= mPreparedUnselectedCount;
+    QCPDataRange lineDataRange = isSelectedSegment ? mPreparedSegments.at(i) : mPreparedSegments.at(i).adjusted(-1, 1);
+    getLines(&mPreparedLines[i], lineDataRange);
+    QCPScatterStyle finalScatterStyle = mScatterStyle;
+    if (isSelectedSegment && mSelectionDecorator)
+      finalScatterStyle = mSelectionDecorator->getFinalScatterStyle(mScatterStyle);
+    if (!finalScatterStyle.isNone())
+      getScatters(&mPreparedScatters[i], mPreparedSegments.at(i));
+  }
+  mGeometryPrepared = true;
+}
+
+/*! \internal
+
+  Releases the geometry computed by \ref prepareGeometry, so the next \ref draw computes it again.
+*/
+void QCPGraph::discardGeometry()
+{
+  mGeometryPrepared = false;
+  mPreparedUnselectedCount = 0;
+  mPreparedSegments.clear();
+  mPreparedLines.clear();
+  mPreparedScatters.clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPGraphGeometryJob
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPGraphGeometryJob
+  \internal
+  \brief Prepares the pixel geometry of one graph, to be run on a thread pool
+
+  Instances are created by \ref QCustomPlot::replot when the plotting hint \ref
+  QCP::phParallelGeometry is set, one per visible graph that is about to be drawn. The job calls
+  \ref QCPGraph::prepareGeometry.
+*/
+
+/*!
+  Creates a job that prepares the geometry of \a graph.
+*/
+QCPGraphGeometryJob::QCPGraphGeometryJob(QCPGraph *graph) :
+  mGraph(graph)
+{
+}
+
+/* inherits documentation from base class */
+void QCPGraphGeometryJob::run()
+{
+  QCPProfileScope profileScope(mGraph->parentPlot()->profiler(), "geometry", mGraph->name());
+  mGraph->prepareGeometry();
+}
 /* end of 'src/plottables/plottable-graph.cpp' */
 
 
@@ -22476,6 +25283,10 @@ int QCPGraph::findIndexBelowY(const QVector<QPointF> *data, double y) const
   \ref QCPDataContainer with \ref QCPCurveData as the DataType template parameter. See the
   documentation there for an explanation regarding the data type's generic methods.
   
+  If the library is compiled with \c QCP_SINGLE_PRECISION_DATA or \c QCP_OFFSET_KEY_DATA, all three
+  members are floats (see \ref QCPDataValue), reducing the size of a data point from 24 to 12
+  bytes. Curve keys aren't stored as offsets, since they usually aren't timestamps.
+  
   \see QCPCurveDataContainer
 */
 
@@ -22618,7 +25429,8 @@ QCPCurveData::QCPCurveData(double t, double key, double value) :
 QCPCurve::QCPCurve(QCPAxis *keyAxis, QCPAxis *valueAxis) :
   QCPAbstractPlottable1D<QCPCurveData>(keyAxis, valueAxis),
   mScatterSkip{},
-  mLineStyle{}
+  mLineStyle{},
+  mAdaptiveSampling{}
 {
   // modify inherited properties from abstract plottable:
   setPen(QPen(Qt::blue, 0));
@@ -22627,6 +25439,7 @@ QCPCurve::QCPCurve(QCPAxis *keyAxis, QCPAxis *valueAxis) :
   setScatterStyle(QCPScatterStyle());
   setLineStyle(lsLine);
   setScatterSkip(0);
+  setAdaptiveSampling(true);
 }
 
 QCPCurve::~QCPCurve()
@@ -22728,6 +25541,24 @@ void QCPCurve::setLineStyle(QCPCurve::LineStyle style)
   mLineStyle = style;
 }
 
+/*!
+  Sets whether adaptive sampling shall be used when generating the line of this curve. Since the
+  data of a curve isn't sorted by key, the per-pixel-column sampling of \ref
+  QCPGraph::setAdaptiveSampling can't be applied. Instead, consecutive points inside the visible
+  axis rect that lie within one device pixel of the previously drawn point are collapsed, keeping
+  only the last of them to connect to the next point. The drawn line thus deviates from the
+  original by less than a pixel, while dense trajectories (e.g. from a data logger sampling
+  faster than the curve moves on screen) need only as many line segments as pixels they cross.
+  
+  By default, adaptive sampling is enabled. Scatters aren't affected by this setting.
+  
+  \see QCPGraph::setAdaptiveSampling
+*/
+void QCPCurve::setAdaptiveSampling(bool enabled)
+{
+  mAdaptiveSampling = enabled;
+}
+
 /*! \overload
   
   Adds the provided points in \a t, \a keys and \a values to the current data. The provided vectors
@@ -22997,9 +25828,7 @@ void QCPCurve::drawScatterPlot(QCPPainter *painter, const QVector<QPointF> &poin
   // draw scatter point symbols:
   applyScattersAntialiasingHint(painter);
   style.applyTo(painter, mPen);
-  foreach (const QPointF &point, points)
-    if (!qIsNaN(point.x()) && !qIsNaN(point.y()))
-      style.drawShape(painter,  point);
+  style.drawShapes(painter, points, scatterSpriteCache(painter));
 }
 
 /*! \internal
@@ -23025,6 +25854,10 @@ void QCPCurve::drawScatterPlot(QCPPainter *painter, const QVector<QPointF> &poin
   function. This is needed here to calculate an accordingly wider margin around the axis rect when
   performing the line optimization.
 
+  If adaptive sampling is enabled (\ref setAdaptiveSampling), runs of points inside the visible
+  rect that stay within one device pixel of the last added point are reduced to their last point
+  while streaming through the data.
+
   Methods that are also involved in the algorithm are: \ref getRegion, \ref getOptimizedPoint, \ref
   getOptimizedCornerPoints \ref mayTraverse, \ref getTraverse, \ref getTraverseCornerPoints.
 
@@ -23053,11 +25886,20 @@ void QCPCurve::getCurveLines(QVector<QPointF> *lines, const QCPDataRange &dataRa
   QCPCurveDataContainer::const_iterator prevIt = itEnd-1;
   int prevRegion = getRegion(prevIt->key, prevIt->value, keyMin, valueMax, keyMax, valueMin);
   QVector<QPointF> trailingPoints; // points that must be applied after all other points (are generated only when handling first point to get virtual segment between last and first point right)
+  // adaptive sampling collapses points in R that are closer than this (in pixels) to the last added point:
+  const double samplingTolerance = mAdaptiveSampling ? 1.0/mParentPlot->bufferDevicePixelRatio() : 0;
+  QPointF pendingPoint; // last collapsed point, added before the next point that isn't collapsed
+  bool hasPendingPoint = false;
   while (it != itEnd)
   {
     const int currentRegion = getRegion(it->key, it->value, keyMin, valueMax, keyMax, valueMin);
     if (currentRegion != prevRegion) // changed region, possibly need to add some optimized edge points or original points if entering R
     {
+      if (hasPendingPoint)
+      {
+        lines->append(pendingPoint);
+        hasPendingPoint = false;
+      }
       if (currentRegion != 5) // segment doesn't end in R, so it's a candidate for removal
       {
         QPointF crossA, crossB;
@@ -23100,7 +25942,20 @@ void QCPCurve::getCurveLines(QVector<QPointF> *lines, const QCPDataRange &dataRa
     {
       if (currentRegion == 5) // still in R, keep adding original points
       {
-        lines->append(coordsToPixels(it->key, it->value));
+        const QPointF point = coordsToPixels(it->key, it->value);
+        if (!lines->isEmpty() && qAbs(point.x()-lines->last().x()) < samplingTolerance && qAbs(point.y()-lines->last().y()) < samplingTolerance)
+        {
+          pendingPoint = point;
+          hasPendingPoint = true;
+        } else
+        {
+          if (hasPendingPoint)
+          {
+            lines->append(pendingPoint);
+            hasPendingPoint = false;
+          }
+          lines->append(point);
+        }
       } else // still outside R, no need to add anything
       {
         // see how this is not doing anything? That's the main optimization...
@@ -23110,6 +25965,8 @@ void QCPCurve::getCurveLines(QVector<QPointF> *lines, const QCPDataRange &dataRa
     prevRegion = currentRegion;
     ++it;
   }
+  if (hasPendingPoint)
+    lines->append(pendingPoint);
   *lines << trailingPoints;
 }
 
@@ -23866,6 +26723,9 @@ void QCPCurve::getTraverseCornerPoints(int prevRegion, int currentRegion, double
   If either the curve has no data or if the line style is \ref lsNone and the scatter style's shape
   is \ref QCPScatterStyle::ssNone (i.e. there is no visual representation of the curve), returns
   -1.0.
+
+  For large curves, the closest data point and line segments are found with the point index (see
+  \ref QCPAbstractPlottable1D::indexedPointDistance) instead of iterating over all data points.
 */
 double QCPCurve::pointDistance(const QPointF &pixelPoint, QCPCurveDataContainer::const_iterator &closestData) const
 {
@@ -23875,6 +26735,9 @@ double QCPCurve::pointDistance(const QPointF &pixelPoint, QCPCurveDataContainer:
   if (mLineStyle == lsNone && mScatterStyle.isNone())
     return -1.0;
   
+  if (mDataContainer->size() > 10000) // below this size, building the point index doesn't pay off
+    return indexedPointDistance(pixelPoint, closestData, mLineStyle != lsNone);
+  
   if (mDataContainer->size() == 1)
   {
     QPointF dataPoint = coordsToPixels(mDataContainer->constBegin()->key, mDataContainer->constBegin()->value);
@@ -23915,6 +26778,514 @@ double QCPCurve::pointDistance(const QPointF &pixelPoint, QCPCurveDataContainer:
 /* end of 'src/plottables/plottable-curve.cpp' */
 
 
+/* including file 'src/renderthread.cpp'    */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPRenderThread
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPRenderThread
+  \brief Draws the frames of a QCustomPlot outside the GUI thread
+
+  An instance of this class is created by \ref QCustomPlot::setAsyncRendering and accessible via
+  \ref QCustomPlot::renderThread. Usually you don't need to create it yourself.
+
+  Each call to \ref QCustomPlot::replot requests a new frame (\ref requestFrame). The render thread
+  then applies all pending data snapshots (\ref submitData), draws the entire plot with the regular
+  QCustomPlot drawing logic onto a QImage and emits \ref frameReady. Requests that arrive while a
+  frame is being drawn are merged into a single following frame, and for each plottable only the
+  most recently submitted snapshot is applied. This way, stale frames and data are dropped and the
+  latency between a snapshot and its appearance on screen is bounded by about two frame times.
+
+  The frames are double-buffered: The render thread draws into a back image, which is swapped with
+  the front image once it's complete. \ref drawFrame (used by \ref QCustomPlot::paintEvent) only
+  blits the front image.
+
+  \see QCustomPlot::setAsyncRendering
+*/
+
+/* start of documentation of signals */
+
+/*! \fn void QCPRenderThread::frameReady()
+
+  This signal is emitted from the render thread whenever a new frame has been finished and can be
+  drawn with \ref drawFrame.
+*/
+
+/* end of documentation of signals */
+
+/*!
+  Creates a render thread for \a parentPlot. The thread must be started with QThread::start.
+*/
+QCPRenderThread::QCPRenderThread(QCustomPlot *parentPlot) :
+  QThread(parentPlot),
+  mParentPlot(parentPlot),
+  mFrameRequested(false),
+  mStopRequested(false),
+  mFrameTime(0)
+{
+}
+
+QCPRenderThread::~QCPRenderThread()
+{
+  stop();
+}
+
+/*!
+  Returns the time in milliseconds that drawing the last frame took in the render thread,
+  including the application of data snapshots.
+*/
+double QCPRenderThread::frameTime() const
+{
+  QMutexLocker locker(&mRequestMutex);
+  return mFrameTime;
+}
+
+/*!
+  Hands a snapshot of the data of \a graph to the render thread. The snapshot is applied with \ref
+  QCPGraph::setData right before the next frame is drawn, so \a data must not be modified anymore
+  after this call. If a previous snapshot of \a graph is still pending, it is discarded.
+
+  This method doesn't request a new frame, call \ref QCustomPlot::replot for that.
+*/
+void QCPRenderThread::submitData(QCPGraph *graph, const QSharedPointer<QCPGraphDataContainer> &data)
+{
+  QMutexLocker locker(&mRequestMutex);
+  for (int i=0; i<mPendingGraphData.size(); ++i)
+  {
+    if (mPendingGraphData.at(i).first == graph)
+    {
+      mPendingGraphData[i].second = data;
+      return;
+    }
+  }
+  mPendingGraphData.append(qMakePair(QPointer<QCPGraph>(graph), data));
+}
+
+/*! \overload
+
+  Hands a snapshot of the data of \a curve to the render thread.
+*/
+void QCPRenderThread::submitData(QCPCurve *curve, const QSharedPointer<QCPCurveDataContainer> &data)
+{
+  QMutexLocker locker(&mRequestMutex);
+  for (int i=0; i<mPendingCurveData.size(); ++i)
+  {
+    if (mPendingCurveData.at(i).first == curve)
+    {
+      mPendingCurveData[i].second = data;
+      return;
+    }
+  }
+  mPendingCurveData.append(qMakePair(QPointer<QCPCurve>(curve), data));
+}
+
+/*!
+  Requests a new frame. If the render thread is currently drawing a frame, exactly one more frame
+  is drawn afterwards, no matter how many requests arrive in the meantime.
+*/
+void QCPRenderThread::requestFrame()
+{
+  QMutexLocker locker(&mRequestMutex);
+  mFrameRequested = true;
+  mRequestCondition.wakeOne();
+}
+
+/*!
+  Stops the render thread after the frame currently being drawn (if any) is finished, and waits
+  for the thread to exit.
+*/
+void QCPRenderThread::stop()
+{
+  {
+    QMutexLocker locker(&mRequestMutex);
+    mStopRequested = true;
+    mRequestCondition.wakeOne();
+  }
+  wait();
+}
+
+/*!
+  Draws the most recent finished frame with \a painter at the top left corner of the painter's
+  device. Returns false if no frame has been finished yet.
+*/
+bool QCPRenderThread::drawFrame(QPainter *painter)
+{
+  QMutexLocker locker(&mFrameMutex);
+  if (mFrontFrame.isNull())
+    return false;
+  painter->drawImage(0, 0, mFrontFrame);
+  return true;
+}
+
+/*! \internal
+
+  The event loop of the render thread: waits for frame requests and draws the frames until \ref
+  stop is called.
+*/
+void QCPRenderThread::run()
+{
+  forever
+  {
+    {
+      QMutexLocker locker(&mRequestMutex);
+      while (!mFrameRequested && !mStopRequested)
+        mRequestCondition.wait(&mRequestMutex);
+      if (mStopRequested)
+        return;
+      mFrameRequested = false; // requests arriving while drawing cause exactly one more frame
+    }
+    renderFrame();
+  }
+}
+
+/*! \internal
+
+  Applies the pending data snapshots to their plottables. Must only be called while holding the
+  plot mutex.
+*/
+void QCPRenderThread::applySnapshots()
+{
+  QList<QPair<QPointer<QCPGraph>, QSharedPointer<QCPGraphDataContainer> > > graphData;
+  QList<QPair<QPointer<QCPCurve>, QSharedPointer<QCPCurveDataContainer> > > curveData;
+  {
+    QMutexLocker locker(&mRequestMutex);
+    graphData.swap(mPendingGraphData);
+    curveData.swap(mPendingCurveData);
+  }
+  for (int i=0; i<graphData.size(); ++i)
+  {
+    if (graphData.at(i).first)
+      graphData.at(i).first->setData(graphData.at(i).second);
+  }
+  for (int i=0; i<curveData.size(); ++i)
+  {
+    if (curveData.at(i).first)
+      curveData.at(i).first->setData(curveData.at(i).second);
+  }
+}
+
+/*! \internal
+
+  Draws one complete frame of the parent plot into the back image and swaps it with the front
+  image. Finally emits \ref frameReady.
+*/
+void QCPRenderThread::renderFrame()
+{
+  QElapsedTimer frameTimer;
+  frameTimer.start();
+  {
+    QMutexLocker plotLocker(&mPlotMutex);
+    QCPProfiler *profiler = mParentPlot->profiler();
+    if (profiler)
+      profiler->beginFrame();
+    const qint64 profilerStart = profiler ? profiler->now() : 0;
+    applySnapshots();
+    const QRect viewport = mParentPlot->viewport();
+    const double ratio = mParentPlot->bufferDevicePixelRatio();
+    const QSize frameSize = viewport.size()*ratio;
+    if (frameSize.isEmpty())
+      return;
+    if (mBackFrame.size() != frameSize)
+      mBackFrame = QImage(frameSize, QImage::Format_ARGB32_Premultiplied);
+#ifdef QCP_DEVICEPIXELRATIO_SUPPORTED
+    mBackFrame.setDevicePixelRatio(ratio);
+#endif
+    mBackFrame.fill(Qt::transparent);
+    QCPPainter painter(&mBackFrame);
+    if (!painter.isActive())
+    {
+      qDebug() << Q_FUNC_INFO << "Couldn't activate painter on frame image";
+      return;
+    }
+    painter.setMode(QCPPainter::pmNoCaching); // label caches are QPixmaps, which must not be created outside the GUI thread
+    if (mParentPlot->mBackgroundBrush.style() != Qt::NoBrush)
+      painter.fillRect(viewport, mParentPlot->mBackgroundBrush);
+    mParentPlot->draw(&painter);
+    painter.end();
+    if (profiler)
+    {
+      profiler->record("frame", QLatin1String("renderFrame"), profilerStart, profiler->now());
+      profiler->endFrame();
+    }
+  }
+  {
+    QMutexLocker locker(&mFrameMutex);
+    mFrontFrame.swap(mBackFrame);
+  }
+  {
+    QMutexLocker locker(&mRequestMutex);
+    mFrameTime = frameTimer.nsecsElapsed()*1e-6;
+  }
+  emit frameReady();
+}
+/* end of 'src/renderthread.cpp' */
+
+
+/* including file 'src/batchrenderer.cpp'   */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPBatchRenderer
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPBatchRenderer
+  \brief Exports large numbers of plots to PNG/PDF files concurrently, without showing any widget
+
+  Each job consists of a target file name, the plot size and a \ref SetupFunction which fills a
+  fresh QCustomPlot with the content of the chart. Jobs are added with \ref addJob and exported
+  with \ref run:
+
+  \code
+  QCPBatchRenderer renderer;
+  foreach (const QString &channel, channels)
+  {
+    renderer.addJob(channel+".png", 800, 400, [channel](QCustomPlot *plot)
+    {
+      plot->addGraph();
+      plot->graph(0)->setData(keysOf(channel), valuesOf(channel));
+      plot->rescaleAxes();
+    });
+  }
+  renderer.run();
+  qDebug() << renderer.chartsPerSecondPerCore() << "charts/s/core";
+  \endcode
+
+  The plots are never shown, so no window system is needed. On a server without a display, run
+  the application with the environment variable \c QT_QPA_PLATFORM=offscreen (a QApplication
+  instance is still required, since QCustomPlot is a QWidget).
+
+  The setup functions are called in the thread that calls \ref run, which must be the GUI thread
+  because the QCustomPlot widgets are created there. The export itself, i.e. the layout, drawing
+  and encoding of the file, happens concurrently on a pool of \ref setThreadCount worker threads,
+  while the calling thread already sets up the following plots. Raster files are drawn directly
+  onto a QImage (see \ref QCustomPlot::toImage and \ref QCustomPlot::saveRastered), PDF files with
+  \ref QCustomPlot::savePdf. Which one is used depends on the file suffix: "pdf" creates a PDF file,
+  any other suffix is passed on to QImage as the image format (e.g. "png", "jpg").
+
+  Since the plots are drawn outside the GUI thread, the setup functions must not use features that
+  require QPixmaps, such as background pixmaps (\ref QCustomPlot::setBackground) or pixmap items.
+
+  After \ref run returns, the throughput of the batch is available via \ref chartsPerSecond and
+  \ref chartsPerSecondPerCore.
+*/
+
+/* start of documentation of inline functions */
+
+/*! \fn double QCPBatchRenderer::elapsedTime() const
+
+  Returns the wall time in milliseconds the last call to \ref run took.
+*/
+
+/* end of documentation of inline functions */
+
+/* start of documentation of signals */
+
+/*! \fn void QCPBatchRenderer::jobFinished(const QString &fileName, bool success)
+
+  This signal is emitted during \ref run (in the calling thread) whenever the file \a fileName has
+  been exported. \a success is false if the file couldn't be written.
+*/
+
+/* end of documentation of signals */
+
+/*!
+  Creates a batch renderer with as many worker threads as there are CPU cores.
+*/
+QCPBatchRenderer::QCPBatchRenderer(QObject *parent) :
+  QObject(parent),
+  mThreadCount(QThread::idealThreadCount()),
+  mExportPen(QCP::epAllowCosmetic),
+  mRenderedCount(0),
+  mFailedCount(0),
+  mElapsedTime(0)
+{
+}
+
+QCPBatchRenderer::~QCPBatchRenderer()
+{
+}
+
+/*!
+  Sets the number of worker threads which export plots concurrently. If \a count is zero or
+  negative, the number of CPU cores is used.
+*/
+void QCPBatchRenderer::setThreadCount(int count)
+{
+  mThreadCount = count > 0 ? count : QThread::idealThreadCount();
+}
+
+/*!
+  Sets whether cosmetic pens are allowed in PDF files (see \ref QCustomPlot::savePdf).
+*/
+void QCPBatchRenderer::setExportPen(QCP::ExportPen exportPen)
+{
+  mExportPen = exportPen;
+}
+
+/*!
+  Returns the number of charts per second the last call to \ref run exported.
+
+  \see chartsPerSecondPerCore
+*/
+double QCPBatchRenderer::chartsPerSecond() const
+{
+  if (mElapsedTime <= 0)
+    return 0;
+  return (mRenderedCount+mFailedCount)/mElapsedTime*1000.0;
+}
+
+/*!
+  Returns \ref chartsPerSecond divided by the number of worker threads, which makes throughput
+  comparable between machines with different core counts.
+*/
+double QCPBatchRenderer::chartsPerSecondPerCore() const
+{
+  return chartsPerSecond()/qMax(1, mThreadCount);
+}
+
+/*!
+  Adds a job to the queue, which exports a plot of \a width and \a height pixels to the file \a
+  fileName. The plot is configured by \a setup before it is exported. Raster images are scaled by
+  \a scale (see \ref QCustomPlot::saveRastered).
+
+  The job is executed by the next call to \ref run.
+*/
+void QCPBatchRenderer::addJob(const QString &fileName, int width, int height, const SetupFunction &setup, double scale)
+{
+  if (width <= 0 || height <= 0)
+  {
+    qDebug() << Q_FUNC_INFO << "Invalid plot size for" << fileName << ":" << width << height;
+    return;
+  }
+  Job job;
+  job.fileName = fileName;
+  job.width = width;
+  job.height = height;
+  job.scale = scale;
+  job.setup = setup;
+  mJobs.append(job);
+}
+
+/*!
+  Removes all jobs which haven't been executed yet.
+*/
+void QCPBatchRenderer::clearJobs()
+{
+  mJobs.clear();
+}
+
+/*!
+  Executes all queued jobs and blocks until all files are exported. Must be called from the GUI
+  thread. Returns the number of successfully exported files.
+
+  At most twice as many plots as there are worker threads exist at the same time, so memory usage
+  doesn't depend on the number of jobs.
+
+  \see chartsPerSecond, jobFinished
+*/
+int QCPBatchRenderer::run()
+{
+  mRenderedCount = 0;
+  mFailedCount = 0;
+  QElapsedTimer timer;
+  timer.start();
+  
+  QThreadPool pool;
+  pool.setMaxThreadCount(mThreadCount);
+  QHash<QCustomPlot*, QString> activePlots;
+  const int maxActivePlots = 2*mThreadCount; // keeps the worker threads busy while the next plots are set up
+  while (!mJobs.isEmpty() || !activePlots.isEmpty())
+  {
+    // set up plots for the next jobs and hand them to the worker threads:
+    while (!mJobs.isEmpty() && activePlots.size() < maxActivePlots)
+    {
+      const Job job = mJobs.takeFirst();
+      QCustomPlot *plot = new QCustomPlot;
+      plot->resize(job.width, job.height);
+      if (job.setup)
+        job.setup(plot);
+      activePlots.insert(plot, job.fileName);
+      pool.start(new QCPBatchRenderTask(this, plot, job.fileName, job.width, job.height, job.scale, mExportPen));
+    }
+    
+    // wait for finished exports and dispose of their plots:
+    QList<QPair<QCustomPlot*, bool> > finishedPlots;
+    {
+      QMutexLocker locker(&mFinishedMutex);
+      while (mFinishedPlots.isEmpty())
+        mFinishedCondition.wait(&mFinishedMutex);
+      finishedPlots.swap(mFinishedPlots);
+    }
+    for (int i=0; i<finishedPlots.size(); ++i)
+    {
+      QCustomPlot *plot = finishedPlots.at(i).first;
+      const bool success = finishedPlots.at(i).second;
+      if (success)
+        ++mRenderedCount;
+      else
+        ++mFailedCount;
+      emit jobFinished(activePlots.take(plot), success);
+      delete plot;
+    }
+  }
+  
+  mElapsedTime = timer.nsecsElapsed()*1e-6;
+  return mRenderedCount;
+}
+
+/*! \internal
+
+  Called by the worker threads when the export of \a plot has finished. Wakes up \ref run, which
+  deletes the plot in the GUI thread.
+*/
+void QCPBatchRenderer::reportFinished(QCustomPlot *plot, bool success)
+{
+  QMutexLocker locker(&mFinishedMutex);
+  mFinishedPlots.append(qMakePair(plot, success));
+  mFinishedCondition.wakeOne();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPBatchRenderTask
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPBatchRenderTask
+  \brief Exports one plot of a QCPBatchRenderer in a worker thread
+
+  This is an internal class used by \ref QCPBatchRenderer::run.
+*/
+
+/*!
+  Creates a task which exports \a plot to \a fileName and reports back to \a renderer. See \ref
+  QCPBatchRenderer::addJob for the meaning of the other parameters.
+*/
+QCPBatchRenderTask::QCPBatchRenderTask(QCPBatchRenderer *renderer, QCustomPlot *plot, const QString &fileName, int width, int height, double scale, QCP::ExportPen exportPen) :
+  mRenderer(renderer),
+  mPlot(plot),
+  mFileName(fileName),
+  mWidth(width),
+  mHeight(height),
+  mScale(scale),
+  mExportPen(exportPen)
+{
+}
+
+/* inherits documentation from base class */
+void QCPBatchRenderTask::run()
+{
+  bool success;
+  if (QFileInfo(mFileName).suffix().compare(QLatin1String("pdf"), Qt::CaseInsensitive) == 0)
+    success = mPlot->savePdf(mFileName, mWidth, mHeight, mExportPen);
+  else
+    success = mPlot->saveRastered(mFileName, mWidth, mHeight, mScale, nullptr); // format is derived from the file suffix
+  if (!success)
+    qDebug() << Q_FUNC_INFO << "Couldn't export plot to" << mFileName;
+  mRenderer->reportFinished(mPlot, success);
+}
+/* end of 'src/batchrenderer.cpp' */
+
+
 /* including file 'src/plottables/plottable-bars.cpp' */
 /* modified 2021-03-29T02:30:44, size 43907           */
 
@@ -24411,7 +27782,8 @@ QCPBars::QCPBars(QCPAxis *keyAxis, QCPAxis *valueAxis) :
   mWidthType(wtPlotCoords),
   mBarsGroup(nullptr),
   mBaseValue(0),
-  mStackingGap(1)
+  mStackingGap(1),
+  mDenseMerging(false)
 {
   // modify inherited properties from abstract plottable:
   mPen.setColor(Qt::blue);
@@ -24533,6 +27905,26 @@ void QCPBars::setStackingGap(double pixels)
   mStackingGap = pixels;
 }
 
+/*!
+  Sets whether bars that are narrower than a pixel shall be merged when drawing. If \a enabled,
+  consecutive bars less than one pixel wide whose centers fall into the same pixel column are drawn
+  as a single rectangle, spanning from the lowest to the highest edge of the merged bars. This
+  applies to stacked bars (\ref moveAbove) and bars in a \ref QCPBarsGroup alike, since the merged
+  rectangles already include the stacking and group offsets. The number of drawn rectangles is
+  then bounded by the axis rect size rather than the number of data points, which makes plots of
+  many thousand bars (e.g. hourly bins over a year) considerably faster.
+  
+  Since overlapping bars aren't drawn on top of each other anymore, translucent brushes appear
+  lighter than without merging, where the overlap accumulates. Data selection and \ref selectTest
+  are unaffected.
+  
+  Dense merging is disabled by default.
+*/
+void QCPBars::setDenseMerging(bool enabled)
+{
+  mDenseMerging = enabled;
+}
+
 /*! \overload
   
   Adds the provided points in \a keys and \a values to the current data. The provided vectors
@@ -24825,6 +28217,20 @@ void QCPBars::draw(QCPPainter *painter)
     if (begin == end)
       continue;
     
+    if (isSelectedSegment && mSelectionDecorator)
+    {
+      mSelectionDecorator->applyBrush(painter);
+      mSelectionDecorator->applyPen(painter);
+    } else
+    {
+      painter->setBrush(mBrush);
+      painter->setPen(mPen);
+    }
+    applyDefaultAntialiasingHint(painter);
+    const bool keyAxisHorizontal = mKeyAxis.data()->orientation() == Qt::Horizontal;
+    QRectF mergedRect; // union of the sub-pixel bars in mergedColumn, while dense merging
+    int mergedColumn = 0;
+    bool merging = false;
     for (QCPBarsDataContainer::const_iterator it=begin; it!=end; ++it)
     {
       // check data validity if flag set:
@@ -24833,18 +28239,32 @@ void QCPBars::draw(QCPPainter *painter)
         qDebug() << Q_FUNC_INFO << "Data point at" << it->key << "of drawn range invalid." << "Plottable name:" << name();
 #endif
       // draw bar:
-      if (isSelectedSegment && mSelectionDecorator)
+      const QRectF barRect = getBarRect(it->key, it->value);
+      if (mDenseMerging && !qIsNaN(it->value) && (keyAxisHorizontal ? barRect.width() : barRect.height()) < 1)
       {
-        mSelectionDecorator->applyBrush(painter);
-        mSelectionDecorator->applyPen(painter);
+        const int column = qFloor(keyAxisHorizontal ? barRect.center().x() : barRect.center().y());
+        if (merging && column == mergedColumn)
+        {
+          mergedRect = mergedRect.united(barRect);
+          continue;
+        }
+        if (merging)
+          painter->drawPolygon(mergedRect);
+        mergedRect = barRect;
+        mergedColumn = column;
+        merging = true;
       } else
       {
-        painter->setBrush(mBrush);
-        painter->setPen(mPen);
+        if (merging)
+        {
+          painter->drawPolygon(mergedRect);
+          merging = false;
+        }
+        painter->drawPolygon(barRect);
       }
-      applyDefaultAntialiasingHint(painter);
-      painter->drawPolygon(getBarRect(it->key, it->value));
     }
+    if (merging)
+      painter->drawPolygon(mergedRect);
   }
   
   // draw other selection decoration that isn't just line/scatter pens and brushes:
@@ -25750,6 +29170,466 @@ QVector<QLineF> QCPStatisticalBox::getWhiskerBarLines(QCPStatisticalBoxDataConta
   result[1].setPoints(coordsToPixels(it->key-mWhiskerWidth*0.5, it->maximum), coordsToPixels(it->key+mWhiskerWidth*0.5, it->maximum)); // max bar
   return result;
 }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPQuantileSketch
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPQuantileSketch
+  \brief Estimates quantiles of a stream of values in bounded memory
+  
+  The sketch is a merging t-digest: Added values are collected in a buffer, which is merged into a
+  sorted list of centroids (weighted means of neighbouring values) whenever it is full or a
+  quantile is requested. Centroids near the median may absorb many values, while centroids at the
+  tails stay small, so extreme quantiles remain accurate. The \ref setCompression parameter bounds
+  the number of centroids to a bit more than half its value, and the buffer holds five times the
+  compression, independently of how many values were added.
+  
+  With the default compression of 100, the sketch takes about 9 kB and the quartiles it returns
+  typically have a rank error below 0.1% (i.e. the returned median lies between the exact 49.9%
+  and 50.1% quantiles). The minimum and maximum are tracked exactly.
+  
+  \see QCPStatisticalBoxAggregator
+*/
+
+/*!
+  Creates an empty sketch with the given \a compression, see \ref setCompression.
+*/
+QCPQuantileSketch::QCPQuantileSketch(double compression) :
+  mCompression(qMax(compression, 10.0)),
+  mTotalWeight(0),
+  mMinimum(std::numeric_limits<double>::infinity()),
+  mMaximum(-std::numeric_limits<double>::infinity())
+{
+}
+
+/*!
+  Sets the compression of the sketch, which trades memory for accuracy: The number of centroids is
+  bounded by a bit more than half of \a compression, and the rank error of the quantile estimates is
+  roughly proportional to its inverse. Values below 10 are raised to 10.
+  
+  Changing the compression of a non-empty sketch only affects how values are merged from now on.
+*/
+void QCPQuantileSketch::setCompression(double compression)
+{
+  mCompression = qMax(compression, 10.0);
+}
+
+/*!
+  Adds \a value with the given \a weight to the sketch. NaN values are ignored.
+*/
+void QCPQuantileSketch::add(double value, double weight)
+{
+  if (qIsNaN(value) || weight <= 0)
+    return;
+  Centroid centroid;
+  centroid.mean = value;
+  centroid.weight = weight;
+  mBuffer.append(centroid);
+  mTotalWeight += weight;
+  if (value < mMinimum) mMinimum = value;
+  if (value > mMaximum) mMaximum = value;
+  if (mBuffer.size() >= 5*int(mCompression))
+    compress();
+}
+
+/*!
+  Returns the estimate of the \a q quantile of the added values, where \a q is between 0 (the
+  minimum) and 1 (the maximum). For example, pass 0.5 to get the median.
+  
+  If the sketch is empty, returns NaN.
+*/
+double QCPQuantileSketch::quantile(double q) const
+{
+  compress();
+  if (mCentroids.isEmpty())
+    return qQNaN();
+  if (mCentroids.size() == 1)
+    return mCentroids.first().mean;
+  
+  // each centroid is located at the center of its weight, interpolate linearly in between and
+  // towards the exact minimum/maximum at the ends:
+  const double index = qBound(0.0, q, 1.0)*mTotalWeight;
+  const Centroid &first = mCentroids.first();
+  if (index < first.weight*0.5)
+    return mMinimum+index/(first.weight*0.5)*(first.mean-mMinimum);
+  double weightSoFar = first.weight*0.5;
+  for (int i=0; i<mCentroids.size()-1; ++i)
+  {
+    const Centroid &lower = mCentroids.at(i);
+    const Centroid &upper = mCentroids.at(i+1);
+    const double weightStep = (lower.weight+upper.weight)*0.5;
+    if (weightSoFar+weightStep > index)
+      return lower.mean+(index-weightSoFar)/weightStep*(upper.mean-lower.mean);
+    weightSoFar += weightStep;
+  }
+  const Centroid &last = mCentroids.last();
+  return last.mean+qMin((index-weightSoFar)/(last.weight*0.5), 1.0)*(mMaximum-last.mean);
+}
+
+/*!
+  Returns the number of centroids the sketch currently consists of. This is mainly useful to assess
+  the memory usage for a given compression.
+*/
+int QCPQuantileSketch::centroidCount() const
+{
+  compress();
+  return mCentroids.size();
+}
+
+/*!
+  Removes all values from the sketch.
+*/
+void QCPQuantileSketch::clear()
+{
+  mCentroids.clear();
+  mBuffer.clear();
+  mTotalWeight = 0;
+  mMinimum = std::numeric_limits<double>::infinity();
+  mMaximum = -std::numeric_limits<double>::infinity();
+}
+
+/*! \internal
+  
+  Merges the buffered values into the centroids. Centroids and buffered values are sorted by their
+  mean and then combined from left to right, as long as the combined centroid doesn't exceed the
+  weight allowed at its quantile (see \ref quantileLimit).
+*/
+void QCPQuantileSketch::compress() const
+{
+  if (mBuffer.isEmpty())
+    return;
+  QVector<Centroid> sorted = mCentroids;
+  sorted += mBuffer;
+  mBuffer.clear();
+  std::sort(sorted.begin(), sorted.end(), [](const Centroid &a, const Centroid &b) { return a.mean < b.mean; });
+  
+  mCentroids.clear();
+  mCentroids.reserve(int(mCompression));
+  double weightSoFar = 0;
+  Centroid current = sorted.first();
+  double weightLimit = mTotalWeight*quantileLimit(0);
+  for (int i=1; i<sorted.size(); ++i)
+  {
+    const Centroid &next = sorted.at(i);
+    const double combinedWeight = current.weight+next.weight;
+    if (weightSoFar+combinedWeight <= weightLimit)
+    {
+      current.mean += (next.mean-current.mean)*next.weight/combinedWeight;
+      current.weight = combinedWeight;
+    } else
+    {
+      weightSoFar += current.weight;
+      mCentroids.append(current);
+      current = next;
+      weightLimit = mTotalWeight*quantileLimit(weightSoFar/mTotalWeight);
+    }
+  }
+  mCentroids.append(current);
+}
+
+/*! \internal
+  
+  Returns the highest quantile up to which a centroid starting at quantile \a q may extend. This
+  uses the arcsine scale function k(q) = compression/(2 pi)*asin(2q-1) of the t-digest, allowing
+  each centroid to span one unit of k. This makes centroids small at the tails and large around the
+  median.
+*/
+double QCPQuantileSketch::quantileLimit(double q) const
+{
+  const double k = mCompression/(2.0*M_PI)*qAsin(2.0*q-1.0)+1.0;
+  if (k >= mCompression*0.25)
+    return 1.0;
+  return (qSin(k*2.0*M_PI/mCompression)+1.0)*0.5;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPStatisticalBoxAggregator
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPStatisticalBoxAggregator
+  \brief Incrementally computes box plot statistics per time bucket from a stream of samples
+  
+  \ref QCPStatisticalBoxData requires the quartiles of all samples of a box. Computing them exactly
+  means storing and sorting every sample. This class instead keeps a \ref QCPQuantileSketch per time
+  bucket, so the memory per bucket is bounded. The boxes in the statistical box data container are
+  updated lazily: \ref addSample only feeds the sketch, and the modified boxes are written once per
+  \ref updateData call (\ref addSamples does this automatically), so the quartile estimation isn't
+  repeated for every sample:
+  \code
+  QCPStatisticalBoxAggregator aggregator(statisticalBox->data(), 3600); // hourly boxes
+  aggregator.setOutlierThreshold(QCPRange(6.0, 8.5));
+  // for each incoming sample:
+  aggregator.addSample(time, value);
+  // before each replot:
+  aggregator.updateData();
+  customPlot->replot();
+  \endcode
+  
+  Buckets have the width \a bucketSize and are centered on the keys \a bucketOffset + n*\a
+  bucketSize for integer n, which are also the keys of the boxes.
+  
+  The quartiles and median of a box are estimated from all samples of its bucket. Samples outside
+  the range set with \ref setOutlierThreshold become outliers of the box, up to the number set with
+  \ref setMaximumOutliers, and the whiskers span the remaining samples exactly.
+  
+  Only the newest buckets keep their sketches (see \ref setOpenBucketCount). Samples for older
+  buckets are rejected, their boxes stay as they are.
+*/
+
+/*!
+  Creates an aggregator that writes the boxes to \a container, with buckets of width \a bucketSize
+  centered on the keys \a bucketOffset + n*\a bucketSize (see \ref setBucket).
+*/
+QCPStatisticalBoxAggregator::QCPStatisticalBoxAggregator(const QSharedPointer<QCPStatisticalBoxDataContainer> &container, double bucketSize, double bucketOffset) :
+  mContainer(container),
+  mBucketSize(bucketSize),
+  mBucketOffset(bucketOffset),
+  mCompression(100),
+  mOutlierThreshold(-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()),
+  mMaximumOutliers(100),
+  mOpenBucketCount(2)
+{
+}
+
+/*!
+  Sets the statistical box data container the boxes are written to. Typically this is the
+  container of a \ref QCPStatisticalBox, see \ref QCPStatisticalBox::data.
+*/
+void QCPStatisticalBoxAggregator::setContainer(const QSharedPointer<QCPStatisticalBoxDataContainer> &container)
+{
+  mContainer = container;
+}
+
+/*!
+  Sets the width of the buckets to \a bucketSize and places their centers on the keys \a
+  bucketOffset + n*\a bucketSize, for integer n.
+  
+  Open buckets are discarded, because their samples can't be redistributed. Their boxes are
+  updated one last time before.
+*/
+void QCPStatisticalBoxAggregator::setBucket(double bucketSize, double bucketOffset)
+{
+  updateData();
+  mBucketSize = bucketSize;
+  mBucketOffset = bucketOffset;
+  mBuckets.clear();
+}
+
+/*!
+  Sets the compression of the quantile sketches of newly opened buckets, see \ref
+  QCPQuantileSketch::setCompression.
+*/
+void QCPStatisticalBoxAggregator::setCompression(double compression)
+{
+  mCompression = compression;
+}
+
+/*!
+  Sets the range of sample values that are considered regular. Samples outside \a threshold are
+  added to the outliers of their box (and excluded from the whiskers). By default, the threshold is
+  infinite, so there are no outliers.
+  
+  \see setMaximumOutliers
+*/
+void QCPStatisticalBoxAggregator::setOutlierThreshold(const QCPRange &threshold)
+{
+  mOutlierThreshold = threshold;
+}
+
+/*!
+  Sets the maximum number of outliers stored per box, to keep the memory per bucket bounded. Once a
+  box holds \a count outliers, further outliers of its bucket still contribute to the quartiles,
+  but aren't listed individually.
+*/
+void QCPStatisticalBoxAggregator::setMaximumOutliers(int count)
+{
+  mMaximumOutliers = qMax(0, count);
+}
+
+/*!
+  Sets the number of the newest buckets which keep their quantile sketches and thus accept samples.
+  The default of two allows samples to arrive slightly late across a bucket boundary. Samples for
+  older buckets are rejected by \ref addSample.
+*/
+void QCPStatisticalBoxAggregator::setOpenBucketCount(int count)
+{
+  mOpenBucketCount = qMax(1, count);
+  while (mBuckets.size() > mOpenBucketCount)
+    closeOldestBucket();
+}
+
+/*!
+  Returns the key of the bucket (and box) that a sample at \a time falls into.
+*/
+double QCPStatisticalBoxAggregator::bucketKey(double time) const
+{
+  return mBucketOffset+qFloor((time-mBucketOffset)/mBucketSize+0.5)*mBucketSize;
+}
+
+/*!
+  Adds the sample \a value at \a time to its bucket. Returns false if the sample was rejected,
+  because its bucket is no longer open (see \ref setOpenBucketCount), or \a value is NaN.
+  
+  The according box in the container is only updated by the next call to \ref updateData (or when
+  the bucket is closed), so call \ref updateData before replotting. This way, the amortized cost of
+  this method is constant and doesn't depend on the compression of the sketches.
+*/
+bool QCPStatisticalBoxAggregator::addSample(double time, double value)
+{
+  if (!mContainer)
+  {
+    qDebug() << Q_FUNC_INFO << "no data container set";
+    return false;
+  }
+  if (mBucketSize <= 0)
+  {
+    qDebug() << Q_FUNC_INFO << "invalid bucket size" << mBucketSize;
+    return false;
+  }
+  if (qIsNaN(value))
+    return false;
+  
+  const double key = bucketKey(time);
+  Bucket *bucket = bucketForSample(key);
+  if (!bucket)
+    return false;
+  addToBucket(bucket, value);
+  return true;
+}
+
+/*!
+  Adds the samples given by \a time and \a value in the given order, see \ref addSample, and then
+  calls \ref updateData, so each affected box is updated only once. If the vectors differ in size,
+  only the common number of samples is added.
+*/
+void QCPStatisticalBoxAggregator::addSamples(const QVector<double> &time, const QVector<double> &value)
+{
+  if (!mContainer || mBucketSize <= 0)
+  {
+    qDebug() << Q_FUNC_INFO << "no data container set or invalid bucket size";
+    return;
+  }
+  const int count = qMin(time.size(), value.size());
+  for (int i=0; i<count; ++i)
+  {
+    if (qIsNaN(value.at(i)))
+      continue;
+    if (Bucket *bucket = bucketForSample(bucketKey(time.at(i))))
+      addToBucket(bucket, value.at(i));
+  }
+  updateData();
+}
+
+/*!
+  Writes the boxes of all buckets that received samples since the last call to the container. The
+  quartiles of each such bucket are estimated once, regardless of how many samples it received.
+  
+  \see addSample
+*/
+void QCPStatisticalBoxAggregator::updateData()
+{
+  if (!mContainer)
+    return;
+  for (QMap<double, Bucket>::iterator it = mBuckets.begin(); it != mBuckets.end(); ++it)
+  {
+    if (it.value().modified)
+      updateBoxData(it.key(), it.value());
+  }
+}
+
+/*!
+  Discards all open buckets, after updating their boxes one last time (see \ref updateData). The
+  boxes already written to the container are kept.
+*/
+void QCPStatisticalBoxAggregator::clear()
+{
+  updateData();
+  mBuckets.clear();
+}
+
+/*! \internal
+  
+  Returns the open bucket with the given \a key, opening a new one if \a key is newer than the
+  oldest open bucket. Opening a bucket closes the oldest ones beyond \ref setOpenBucketCount.
+  Returns \c nullptr if \a key belongs to an already closed bucket.
+*/
+QCPStatisticalBoxAggregator::Bucket *QCPStatisticalBoxAggregator::bucketForSample(double key)
+{
+  QMap<double, Bucket>::iterator it = mBuckets.find(key);
+  if (it != mBuckets.end())
+    return &it.value();
+  if (mBuckets.size() >= mOpenBucketCount && key < mBuckets.firstKey())
+    return nullptr;
+  
+  Bucket bucket;
+  bucket.sketch.setCompression(mCompression);
+  bucket.minimum = std::numeric_limits<double>::infinity();
+  bucket.maximum = -std::numeric_limits<double>::infinity();
+  bucket.modified = false;
+  mBuckets.insert(key, bucket);
+  while (mBuckets.size() > mOpenBucketCount)
+    closeOldestBucket();
+  return &mBuckets[key];
+}
+
+/*! \internal
+  
+  Removes the oldest open bucket, after writing its box to the container if it has samples that
+  aren't reflected there yet.
+*/
+void QCPStatisticalBoxAggregator::closeOldestBucket()
+{
+  QMap<double, Bucket>::iterator it = mBuckets.begin();
+  if (it.value().modified && mContainer)
+    updateBoxData(it.key(), it.value());
+  mBuckets.erase(it);
+}
+
+/*! \internal
+  
+  Adds \a value to the sketch of \a bucket, and to either its whisker range or its outliers.
+*/
+void QCPStatisticalBoxAggregator::addToBucket(Bucket *bucket, double value)
+{
+  bucket->sketch.add(value);
+  bucket->modified = true;
+  if (mOutlierThreshold.contains(value))
+  {
+    if (value < bucket->minimum) bucket->minimum = value;
+    if (value > bucket->maximum) bucket->maximum = value;
+  } else if (bucket->outliers.size() < mMaximumOutliers)
+    bucket->outliers.append(value);
+}
+
+/*! \internal
+  
+  Writes the box statistics of \a bucket to the box with \a key in the container, adding the box
+  if it doesn't exist yet, and marks the bucket as unmodified. The newest box is found in constant
+  time.
+*/
+void QCPStatisticalBoxAggregator::updateBoxData(double key, Bucket &bucket)
+{
+  bucket.modified = false;
+  const double lowerQuartile = bucket.sketch.quantile(0.25);
+  const double median = bucket.sketch.quantile(0.5);
+  const double upperQuartile = bucket.sketch.quantile(0.75);
+  QCPStatisticalBoxData box(key,
+                            bucket.minimum <= bucket.maximum ? qMin(bucket.minimum, lowerQuartile) : lowerQuartile, // if all samples are outliers, whiskers collapse onto the box
+                            lowerQuartile, median, upperQuartile,
+                            bucket.minimum <= bucket.maximum ? qMax(bucket.maximum, upperQuartile) : upperQuartile,
+                            bucket.outliers);
+  
+  int index = mContainer->size()-1;
+  if (mContainer->isEmpty() || (mContainer->constEnd()-1)->key != key)
+    index = int(mContainer->findBegin(key, false)-mContainer->constBegin());
+  if (index < mContainer->size() && (mContainer->constBegin()+index)->key == key)
+    *(mContainer->begin()+index) = box;
+  else
+    mContainer->add(box);
+}
 /* end of 'src/plottables/plottable-statisticalbox.cpp' */
 
 
@@ -25818,7 +29698,9 @@ QCPColorMapData::QCPColorMapData(int keySize, int valueSize, const QCPRange &key
   mIsEmpty(true),
   mData(nullptr),
   mAlpha(nullptr),
-  mDataModified(true)
+  mDataModified(true),
+  mKeyOffset(0),
+  mAppendedColumns(0)
 {
   setSize(keySize, valueSize);
   fill(0);
@@ -25839,7 +29721,9 @@ QCPColorMapData::QCPColorMapData(const QCPColorMapData &other) :
   mIsEmpty(true),
   mData(nullptr),
   mAlpha(nullptr),
-  mDataModified(true)
+  mDataModified(true),
+  mKeyOffset(0),
+  mAppendedColumns(0)
 {
   *this = other;
 }
@@ -25867,6 +29751,7 @@ QCPColorMapData &QCPColorMapData::operator=(const QCPColorMapData &other)
         memcpy(mAlpha, other.mAlpha, sizeof(mAlpha[0])*size_t(keySize*valueSize));
     }
     mDataBounds = other.mDataBounds;
+    mKeyOffset = other.mKeyOffset;
     mDataModified = true;
   }
   return *this;
@@ -25878,7 +29763,7 @@ double QCPColorMapData::data(double key, double value)
   int keyCell = int( (key-mKeyRange.lower)/(mKeyRange.upper-mKeyRange.lower)*(mKeySize-1)+0.5 );
   int valueCell = int( (value-mValueRange.lower)/(mValueRange.upper-mValueRange.lower)*(mValueSize-1)+0.5 );
   if (keyCell >= 0 && keyCell < mKeySize && valueCell >= 0 && valueCell < mValueSize)
-    return mData[valueCell*mKeySize + keyCell];
+    return mData[valueCell*mKeySize + storageKeyIndex(keyCell)];
   else
     return 0;
 }
@@ -25887,7 +29772,7 @@ double QCPColorMapData::data(double key, double value)
 double QCPColorMapData::cell(int keyIndex, int valueIndex)
 {
   if (keyIndex >= 0 && keyIndex < mKeySize && valueIndex >= 0 && valueIndex < mValueSize)
-    return mData[valueIndex*mKeySize + keyIndex];
+    return mData[valueIndex*mKeySize + storageKeyIndex(keyIndex)];
   else
     return 0;
 }
@@ -25903,7 +29788,7 @@ double QCPColorMapData::cell(int keyIndex, int valueIndex)
 unsigned char QCPColorMapData::alpha(int keyIndex, int valueIndex)
 {
   if (mAlpha && keyIndex >= 0 && keyIndex < mKeySize && valueIndex >= 0 && valueIndex < mValueSize)
-    return mAlpha[valueIndex*mKeySize + keyIndex];
+    return mAlpha[valueIndex*mKeySize + storageKeyIndex(keyIndex)];
   else
     return 255;
 }
@@ -25926,6 +29811,7 @@ void QCPColorMapData::setSize(int keySize, int valueSize)
   {
     mKeySize = keySize;
     mValueSize = valueSize;
+    mKeyOffset = 0;
     delete[] mData;
     mIsEmpty = mKeySize == 0 || mValueSize == 0;
     if (!mIsEmpty)
@@ -26045,7 +29931,7 @@ void QCPColorMapData::setData(double key, double value, double z)
   int valueCell = int( (value-mValueRange.lower)/(mValueRange.upper-mValueRange.lower)*(mValueSize-1)+0.5 );
   if (keyCell >= 0 && keyCell < mKeySize && valueCell >= 0 && valueCell < mValueSize)
   {
-    mData[valueCell*mKeySize + keyCell] = z;
+    mData[valueCell*mKeySize + storageKeyIndex(keyCell)] = z;
     if (z < mDataBounds.lower)
       mDataBounds.lower = z;
     if (z > mDataBounds.upper)
@@ -26069,7 +29955,7 @@ void QCPColorMapData::setCell(int keyIndex, int valueIndex, double z)
 {
   if (keyIndex >= 0 && keyIndex < mKeySize && valueIndex >= 0 && valueIndex < mValueSize)
   {
-    mData[valueIndex*mKeySize + keyIndex] = z;
+    mData[valueIndex*mKeySize + storageKeyIndex(keyIndex)] = z;
     if (z < mDataBounds.lower)
       mDataBounds.lower = z;
     if (z > mDataBounds.upper)
@@ -26100,13 +29986,61 @@ void QCPColorMapData::setAlpha(int keyIndex, int valueIndex, unsigned char alpha
   {
     if (mAlpha || createAlpha())
     {
-      mAlpha[valueIndex*mKeySize + keyIndex] = alpha;
+      mAlpha[valueIndex*mKeySize + storageKeyIndex(keyIndex)] = alpha;
       mDataModified = true;
     }
   } else
     qDebug() << Q_FUNC_INFO << "index out of bounds:" << keyIndex << valueIndex;
 }
 
+/*!
+  Scrolls the map by one cell in the key direction, for waterfall displays such as live
+  spectrograms: The column of cells with key index 0 is discarded, all other columns move to the
+  next lower key index, and \a values (which must have \ref valueSize entries, ordered by value
+  index) become the new column at key index \ref keySize-1. If an alpha map exists, the new column
+  is fully opaque. The key range (\ref setKeyRange) is shifted by one cell width, so the remaining
+  cells keep their plot coordinates.
+  
+  The cost of this method is proportional to \ref valueSize only: The key columns are stored as a
+  ring, so no data is moved. Further, as long as no other cells were modified since the last
+  replot, the \ref QCPColorMap only colorizes the appended columns on the next replot, instead of
+  the entire map.
+  
+  \see setCell
+*/
+void QCPColorMapData::appendKeyColumn(const QVector<double> &values)
+{
+  if (isEmpty())
+    return;
+  if (values.size() != mValueSize)
+  {
+    qDebug() << Q_FUNC_INFO << "column size" << values.size() << "doesn't match value size" << mValueSize;
+    return;
+  }
+  
+  // the oldest column (key index 0) is overwritten by the new one, which thereby becomes the last:
+  const int column = mKeyOffset;
+  for (int valueIndex=0; valueIndex<mValueSize; ++valueIndex)
+  {
+    const double z = values.at(valueIndex);
+    mData[valueIndex*mKeySize + column] = z;
+    if (z < mDataBounds.lower)
+      mDataBounds.lower = z;
+    if (z > mDataBounds.upper)
+      mDataBounds.upper = z;
+    if (mAlpha)
+      mAlpha[valueIndex*mKeySize + column] = 255;
+  }
+  mKeyOffset = column+1 < mKeySize ? column+1 : 0;
+  if (mKeySize > 1)
+  {
+    const double cellWidth = (mKeyRange.upper-mKeyRange.lower)/double(mKeySize-1);
+    mKeyRange += cellWidth;
+  }
+  if (mAppendedColumns < mKeySize)
+    ++mAppendedColumns;
+}
+
 /*!
   Goes through the data and updates the buffered minimum and maximum data values.
   
@@ -26412,7 +30346,9 @@ QCPColorMap::QCPColorMap(QCPAxis *keyAxis, QCPAxis *valueAxis) :
   mGradient(QCPColorGradient::gpCold),
   mInterpolate(true),
   mTightBoundary(false),
-  mMapImageInvalidated(true)
+  mColorizeThreadCount(0),
+  mMapImageInvalidated(true),
+  mColorizeThreadPool(new QThreadPool(this)) // created here on the owning thread, updateMapImage may run on render or raster threads
 {
 }
 
@@ -26574,6 +30510,23 @@ void QCPColorMap::setColorScale(QCPColorScale *colorScale)
   }
 }
 
+/*!
+  Sets the number of threads used to turn the data into the map image, when the data or the map
+  image was changed.
+  
+  Large maps are split into ranges of scanlines which are colorized concurrently on a thread pool
+  owned by this color map. If \a threadCount is zero (the default), the number of threads is chosen
+  according to QThread::idealThreadCount. Setting \a threadCount to one colorizes the map on the
+  calling thread only. Small maps are always colorized on the calling thread, since there the
+  overhead of dispatching jobs would outweigh the gain.
+  
+  The resulting map image is identical for any thread count.
+*/
+void QCPColorMap::setColorizeThreadCount(int threadCount)
+{
+  mColorizeThreadCount = qMax(0, threadCount);
+}
+
 /*!
   Sets the data range (\ref setDataRange) to span the minimum and maximum values that occur in the
   current data set. This corresponds to the \ref rescaleKeyAxis or \ref rescaleValueAxis methods,
@@ -26624,7 +30577,18 @@ void QCPColorMap::updateLegendIcon(Qt::TransformationMode transformMode, const Q
   {
     bool mirrorX = (keyAxis()->orientation() == Qt::Horizontal ? keyAxis() : valueAxis())->rangeReversed();
     bool mirrorY = (valueAxis()->orientation() == Qt::Vertical ? valueAxis() : keyAxis())->rangeReversed();
-    mLegendIcon = QPixmap::fromImage(mMapImage.mirrored(mirrorX, mirrorY)).scaled(thumbSize, Qt::KeepAspectRatio, transformMode);
+    if (mMapData->mKeyOffset == 0)
+    {
+      mLegendIcon = QPixmap::fromImage(mMapImage.mirrored(mirrorX, mirrorY)).scaled(thumbSize, Qt::KeepAspectRatio, transformMode);
+    } else // map image is a ring of key columns (see QCPColorMapData::appendKeyColumn), stitch it in key order first
+    {
+      QImage iconImage(mMapImage.size(), mMapImage.format());
+      iconImage.fill(Qt::transparent);
+      QPainter iconPainter(&iconImage);
+      drawMapImage(&iconPainter, iconImage.rect(), mirrorX, mirrorY);
+      iconPainter.end();
+      mLegendIcon = QPixmap::fromImage(iconImage).scaled(thumbSize, Qt::KeepAspectRatio, transformMode);
+    }
   }
 }
 
@@ -26755,33 +30719,26 @@ void QCPColorMap::updateMapImage()
     } else if (!mUndersampledMapImage.isNull())
       mUndersampledMapImage = QImage(); // don't need oversampling mechanism anymore (map size has changed) but mUndersampledMapImage still has nonzero size, free it
     
-    const double *rawData = mMapData->mData;
-    const unsigned char *rawAlpha = mMapData->mAlpha;
-    if (keyAxis->orientation() == Qt::Horizontal)
-    {
-      const int lineCount = valueSize;
-      const int rowCount = keySize;
-      for (int line=0; line<lineCount; ++line)
-      {
-        QRgb* pixels = reinterpret_cast<QRgb*>(localMapImage->scanLine(lineCount-1-line)); // invert scanline index because QImage counts scanlines from top, but our vertical index counts from bottom (mathematical coordinate system)
-        if (rawAlpha)
-          mGradient.colorize(rawData+line*rowCount, rawAlpha+line*rowCount, mDataRange, pixels, rowCount, 1, mDataScaleType==QCPAxis::stLogarithmic);
-        else
-          mGradient.colorize(rawData+line*rowCount, mDataRange, pixels, rowCount, 1, mDataScaleType==QCPAxis::stLogarithmic);
-      }
-    } else // keyAxis->orientation() == Qt::Vertical
-    {
-      const int lineCount = keySize;
-      const int rowCount = valueSize;
-      for (int line=0; line<lineCount; ++line)
-      {
-        QRgb* pixels = reinterpret_cast<QRgb*>(localMapImage->scanLine(lineCount-1-line)); // invert scanline index because QImage counts scanlines from top, but our vertical index counts from bottom (mathematical coordinate system)
-        if (rawAlpha)
-          mGradient.colorize(rawData+line, rawAlpha+line, mDataRange, pixels, rowCount, lineCount, mDataScaleType==QCPAxis::stLogarithmic);
-        else
-          mGradient.colorize(rawData+line, mDataRange, pixels, rowCount, lineCount, mDataScaleType==QCPAxis::stLogarithmic);
-      }
-    }
+    uchar *bits = localMapImage->bits(); // detach once here, the jobs must not call the detaching QImage::scanLine concurrently
+    const int bytesPerLine = int(localMapImage->bytesPerLine());
+    const int lineCount = keyAxis->orientation() == Qt::Horizontal ? valueSize : keySize;
+    const int threadCount = qMin(mColorizeThreadCount > 0 ? mColorizeThreadCount : QThread::idealThreadCount(), lineCount);
+    const int minCellsPerJob = 128*128; // below this, dispatching a job costs more than colorizing the lines directly
+    const int jobCount = qMin(threadCount, int(qint64(keySize)*qint64(valueSize)/minCellsPerJob));
+    if (jobCount > 1)
+    {
+      // the jobs share mGradient, so make sure its color buffer is up to date before they start:
+      if (mGradient.mColorBufferInvalidated)
+        mGradient.updateColorBuffer();
+      mColorizeThreadPool->setMaxThreadCount(jobCount-1);
+      // the calling thread colorizes the first line range itself, the remaining ones go to the pool:
+      const int linesPerJob = (lineCount+jobCount-1)/jobCount;
+      for (int beginLine=linesPerJob; beginLine<lineCount; beginLine+=linesPerJob)
+        mColorizeThreadPool->start(new QCPColorizeJob(this, bits, bytesPerLine, beginLine, qMin(beginLine+linesPerJob, lineCount)));
+      colorizeLines(bits, bytesPerLine, 0, qMin(linesPerJob, lineCount));
+      mColorizeThreadPool->waitForDone();
+    } else
+      colorizeLines(bits, bytesPerLine, 0, lineCount);
     
     if (keyOversamplingFactor > 1 || valueOversamplingFactor > 1)
     {
@@ -26792,9 +30749,158 @@ void QCPColorMap::updateMapImage()
     }
   }
   mMapData->mDataModified = false;
+  mMapData->mAppendedColumns = 0;
   mMapImageInvalidated = false;
 }
 
+/*! \internal
+  
+  Colorizes the lines \a beginLine (inclusive) to \a endLine (exclusive) of the map data into
+  the according scanlines of the image data \a bits with \a bytesPerLine. The image must already
+  have the cell dimensions of the map in the orientation of the key axis. A line is a row of cells with constant value index if the key
+  axis is horizontal, and a column of cells with constant key index otherwise.
+  
+  Distinct line ranges write to distinct scanlines, so this method may be called concurrently for
+  disjoint ranges, as long as the color buffer of \ref mGradient is up to date (see \ref
+  updateMapImage).
+*/
+void QCPColorMap::colorizeLines(uchar *bits, int bytesPerLine, int beginLine, int endLine)
+{
+  const double *rawData = mMapData->mData;
+  const unsigned char *rawAlpha = mMapData->mAlpha;
+  const bool logarithmic = mDataScaleType == QCPAxis::stLogarithmic;
+  if (mKeyAxis.data()->orientation() == Qt::Horizontal)
+  {
+    const int lineCount = mMapData->valueSize();
+    const int rowCount = mMapData->keySize();
+    for (int line=beginLine; line<endLine; ++line)
+    {
+      QRgb* pixels = reinterpret_cast<QRgb*>(bits+qint64(lineCount-1-line)*bytesPerLine); // invert scanline index because QImage counts scanlines from top, but our vertical index counts from bottom (mathematical coordinate system)
+      if (rawAlpha)
+        mGradient.colorize(rawData+line*rowCount, rawAlpha+line*rowCount, mDataRange, pixels, rowCount, 1, logarithmic);
+      else
+        mGradient.colorize(rawData+line*rowCount, mDataRange, pixels, rowCount, 1, logarithmic);
+    }
+  } else // keyAxis->orientation() == Qt::Vertical
+  {
+    const int lineCount = mMapData->keySize();
+    const int rowCount = mMapData->valueSize();
+    for (int line=beginLine; line<endLine; ++line)
+    {
+      QRgb* pixels = reinterpret_cast<QRgb*>(bits+qint64(lineCount-1-line)*bytesPerLine); // invert scanline index because QImage counts scanlines from top, but our vertical index counts from bottom (mathematical coordinate system)
+      if (rawAlpha)
+        mGradient.colorize(rawData+line, rawAlpha+line, mDataRange, pixels, rowCount, lineCount, logarithmic);
+      else
+        mGradient.colorize(rawData+line, mDataRange, pixels, rowCount, lineCount, logarithmic);
+    }
+  }
+}
+
+/*! \internal
+  
+  Colorizes only the key columns that were appended with \ref QCPColorMapData::appendKeyColumn
+  since the last map image update, into their ring positions of the map image. This makes the
+  update cost of waterfall displays proportional to the value size of the map.
+  
+  If the map image is oversampled (see \ref updateMapImage) or all columns were replaced, this
+  falls back to a full \ref updateMapImage.
+*/
+void QCPColorMap::updateMapImageColumns()
+{
+  QCPAxis *keyAxis = mKeyAxis.data();
+  if (!keyAxis) return;
+  const int keySize = mMapData->keySize();
+  const int valueSize = mMapData->valueSize();
+  const int appendedColumns = mMapData->mAppendedColumns;
+  const bool horizontal = keyAxis->orientation() == Qt::Horizontal;
+  const QSize cellSize = horizontal ? QSize(keySize, valueSize) : QSize(valueSize, keySize);
+  if (appendedColumns >= keySize || mMapImage.size() != cellSize || !mUndersampledMapImage.isNull())
+  {
+    updateMapImage();
+    return;
+  }
+  
+  uchar *bits = mMapImage.bits();
+  const int bytesPerLine = int(mMapImage.bytesPerLine());
+  const int firstColumn = mMapData->mKeyOffset-appendedColumns; // storage index of the oldest appended column, may wrap below zero
+  if (horizontal)
+  {
+    // key columns are image columns, colorize them into a buffer and scatter it down the scanlines:
+    const double *rawData = mMapData->mData;
+    const unsigned char *rawAlpha = mMapData->mAlpha;
+    const bool logarithmic = mDataScaleType == QCPAxis::stLogarithmic;
+    QVector<QRgb> columnPixels(valueSize);
+    for (int i=0; i<appendedColumns; ++i)
+    {
+      const int column = firstColumn+i < 0 ? firstColumn+i+keySize : firstColumn+i;
+      if (rawAlpha)
+        mGradient.colorize(rawData+column, rawAlpha+column, mDataRange, columnPixels.data(), valueSize, keySize, logarithmic);
+      else
+        mGradient.colorize(rawData+column, mDataRange, columnPixels.data(), valueSize, keySize, logarithmic);
+      for (int valueIndex=0; valueIndex<valueSize; ++valueIndex)
+        reinterpret_cast<QRgb*>(bits+qint64(valueSize-1-valueIndex)*bytesPerLine)[column] = columnPixels.at(valueIndex); // invert scanline index, see colorizeLines
+    }
+  } else // keyAxis->orientation() == Qt::Vertical
+  {
+    // key columns are scanlines, so they can be colorized in place:
+    for (int i=0; i<appendedColumns; ++i)
+    {
+      const int column = firstColumn+i < 0 ? firstColumn+i+keySize : firstColumn+i;
+      colorizeLines(bits, bytesPerLine, column, column+1);
+    }
+  }
+  mMapData->mAppendedColumns = 0;
+}
+
+/*! \internal
+  
+  Draws the map image into \a targetRect with \a painter, mirrored horizontally and/or vertically
+  according to \a mirrorX and \a mirrorY.
+  
+  The key columns of the map image are stored in the same ring order as the data (see \ref
+  QCPColorMapData::appendKeyColumn). If the ring doesn't start at the first image column, the image
+  is drawn as two parts, which are placed in key order. In that case the mirroring is done with the
+  painter transform instead of a mirrored copy of the image. Note that with \ref setInterpolate
+  enabled, no interpolation happens across the seam between the two parts.
+*/
+void QCPColorMap::drawMapImage(QPainter *painter, const QRectF &targetRect, bool mirrorX, bool mirrorY) const
+{
+  const int keySize = mMapData->keySize();
+  const int keyOffset = mMapData->mKeyOffset;
+  if (keyOffset == 0 || mMapImage.isNull())
+  {
+    painter->drawImage(targetRect, mMapImage.mirrored(mirrorX, mirrorY));
+    return;
+  }
+  
+  painter->save();
+  if (mirrorX || mirrorY)
+  {
+    painter->translate(targetRect.center());
+    painter->scale(mirrorX ? -1 : 1, mirrorY ? -1 : 1);
+    painter->translate(-targetRect.center());
+  }
+  const double olderFraction = (keySize-keyOffset)/double(keySize); // share of the keys stored from keyOffset to the end of the ring, these are the lower keys
+  const int width = mMapImage.width();
+  const int height = mMapImage.height();
+  if (mKeyAxis.data()->orientation() == Qt::Horizontal)
+  {
+    // storage column c is at image x = c*oversampling, keys increase to the right:
+    const int splitX = int(qint64(keyOffset)*width/keySize);
+    const double splitTargetX = targetRect.left()+targetRect.width()*olderFraction;
+    painter->drawImage(QRectF(targetRect.left(), targetRect.top(), splitTargetX-targetRect.left(), targetRect.height()), mMapImage, QRectF(splitX, 0, width-splitX, height));
+    painter->drawImage(QRectF(splitTargetX, targetRect.top(), targetRect.right()-splitTargetX, targetRect.height()), mMapImage, QRectF(0, 0, splitX, height));
+  } else // keyAxis->orientation() == Qt::Vertical
+  {
+    // storage column c is at image y = (keySize-1-c)*oversampling, keys increase upwards:
+    const int splitY = height-int(qint64(keyOffset)*height/keySize);
+    const double splitTargetY = targetRect.bottom()-targetRect.height()*olderFraction;
+    painter->drawImage(QRectF(targetRect.left(), splitTargetY, targetRect.width(), targetRect.bottom()-splitTargetY), mMapImage, QRectF(0, 0, width, splitY));
+    painter->drawImage(QRectF(targetRect.left(), targetRect.top(), targetRect.width(), splitTargetY-targetRect.top()), mMapImage, QRectF(0, splitY, width, height-splitY));
+  }
+  painter->restore();
+}
+
 /* inherits documentation from base class */
 void QCPColorMap::draw(QCPPainter *painter)
 {
@@ -26804,6 +30910,8 @@ void QCPColorMap::draw(QCPPainter *painter)
   
   if (mMapData->mDataModified || mMapImageInvalidated)
     updateMapImage();
+  else if (mMapData->mAppendedColumns > 0)
+    updateMapImageColumns();
   
   // use buffer if painting vectorized (PDF):
   const bool useBuffer = painter->modes().testFlag(QCPPainter::pmVectorized);
@@ -26852,7 +30960,7 @@ void QCPColorMap::draw(QCPPainter *painter)
                                   coordsToPixels(mMapData->keyRange().upper, mMapData->valueRange().upper)).normalized();
     localPainter->setClipRect(tightClipRect, Qt::IntersectClip);
   }
-  localPainter->drawImage(imageRect, mMapImage.mirrored(mirrorX, mirrorY));
+  drawMapImage(localPainter, imageRect, mirrorX, mirrorY);
   if (mTightBoundary)
     localPainter->setClipRegion(clipBackup);
   localPainter->setRenderHint(QPainter::SmoothPixmapTransform, smoothBackup);
@@ -26883,6 +30991,39 @@ void QCPColorMap::drawLegendIcon(QCPPainter *painter, const QRectF &rect) const
   painter->drawRect(rect.adjusted(1, 1, 0, 0));
   */
 }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPColorizeJob
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPColorizeJob
+  \internal
+  \brief Colorizes a range of lines of a QCPColorMap, to be run on a thread pool
+  
+  The job is used by \ref QCPColorMap::updateMapImage to split the colorization of large maps
+  across threads (see \ref QCPColorMap::setColorizeThreadCount). It just calls \ref
+  QCPColorMap::colorizeLines with its line range.
+*/
+
+/*!
+  Creates a job that colorizes the lines \a beginLine (inclusive) to \a endLine (exclusive) of
+  \a colorMap into the image data \a bits with \a bytesPerLine.
+*/
+QCPColorizeJob::QCPColorizeJob(QCPColorMap *colorMap, uchar *bits, int bytesPerLine, int beginLine, int endLine) :
+  mColorMap(colorMap),
+  mBits(bits),
+  mBytesPerLine(bytesPerLine),
+  mBeginLine(beginLine),
+  mEndLine(endLine)
+{
+}
+
+/* inherits documentation from base class */
+void QCPColorizeJob::run()
+{
+  mColorMap->colorizeLines(mBits, mBytesPerLine, mBeginLine, mEndLine);
+}
 /* end of 'src/plottables/plottable-colormap.cpp' */
 
 
@@ -27368,6 +31509,9 @@ QCPRange QCPFinancial::getValueRange(bool &foundRange, QCP::SignDomain inSignDom
   value passed as \a timeBinOffset doesn't need to be in the range encompassed by the \a time keys.
   It merely defines the mathematical offset/phase of the bins that will be used to process the
   data.
+  
+  To bin samples that arrive one at a time, without converting the whole series again for each
+  sample, use a \ref QCPOhlcAggregator instead.
 */
 QCPFinancialDataContainer QCPFinancial::timeSeriesToOhlc(const QVector<double> &time, const QVector<double> &value, double timeBinSize, double timeBinOffset)
 {
@@ -27845,6 +31989,137 @@ QRectF QCPFinancial::selectionHitBox(QCPFinancialDataContainer::const_iterator i
   else
     return QRectF(highPixel, keyPixel-keyWidthPixels, lowPixel-highPixel, keyWidthPixels*2).normalized();
 }
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPOhlcAggregator
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPOhlcAggregator
+  \brief Incrementally bins a stream of time/value samples into OHLC data
+  
+  While \ref QCPFinancial::timeSeriesToOhlc converts a complete time series at once, this class
+  maintains the binned open-high-low-close data of a series whose samples arrive one by one, e.g.
+  a live measurement shown as candles per five minutes. Each sample passed to \ref addSample either
+  updates the bin it falls into, or appends a new bin to the financial data container. Both is done
+  in place and in constant time for samples arriving in time order, so the cost per sample doesn't
+  grow with the length of the series.
+  
+  The aggregator operates directly on the data container of a \ref QCPFinancial:
+  \code
+  QCPOhlcAggregator aggregator(financial->data(), 5*60);
+  // for each incoming sample:
+  aggregator.addSample(time, value);
+  customPlot->replot();
+  \endcode
+  
+  Bins have the width \a timeBinSize and are centered on the keys \a timeBinOffset + n*\a
+  timeBinSize for integer n, like the bins created by \ref QCPFinancial::timeSeriesToOhlc. The open
+  and close of a bin are the first and last sample added to it. A sample that is older than the last
+  bin updates the high and low of its bin (or inserts a new bin if it falls into a gap), but not its
+  open and close.
+*/
+
+/*!
+  Creates an aggregator that adds the samples binned to \a container. The bins have the width \a
+  timeBinSize and are centered on the keys \a timeBinOffset + n*\a timeBinSize (see \ref
+  setTimeBin).
+  
+  \a container may already hold data, e.g. the result of \ref QCPFinancial::timeSeriesToOhlc with
+  the same bin parameters. Samples that fall into the last existing bin then continue that bin.
+*/
+QCPOhlcAggregator::QCPOhlcAggregator(const QSharedPointer<QCPFinancialDataContainer> &container, double timeBinSize, double timeBinOffset) :
+  mContainer(container),
+  mTimeBinSize(timeBinSize),
+  mTimeBinOffset(timeBinOffset)
+{
+}
+
+/*!
+  Sets the financial data container which the bins are added to. Typically this is the container of
+  a \ref QCPFinancial, see \ref QCPFinancial::data.
+*/
+void QCPOhlcAggregator::setContainer(const QSharedPointer<QCPFinancialDataContainer> &container)
+{
+  mContainer = container;
+}
+
+/*!
+  Sets the width of the bins to \a timeBinSize and places their centers on the keys \a
+  timeBinOffset + n*\a timeBinSize, for integer n.
+  
+  Bins that already exist in the container are not rebinned.
+*/
+void QCPOhlcAggregator::setTimeBin(double timeBinSize, double timeBinOffset)
+{
+  mTimeBinSize = timeBinSize;
+  mTimeBinOffset = timeBinOffset;
+}
+
+/*!
+  Returns the key of the bin that a sample at \a time falls into.
+*/
+double QCPOhlcAggregator::binKey(double time) const
+{
+  return mTimeBinOffset+qFloor((time-mTimeBinOffset)/mTimeBinSize+0.5)*mTimeBinSize;
+}
+
+/*!
+  Adds the sample \a value at \a time to the bin it falls into.
+  
+  If \a time lies in the last bin of the container, that bin's high, low and close are updated. If
+  it lies after the last bin, a new bin is appended with all four values set to \a value. Both
+  cases take constant time.
+  
+  Samples older than the last bin are merged into their bin with a binary search, only extending
+  its high and low.
+*/
+void QCPOhlcAggregator::addSample(double time, double value)
+{
+  if (!mContainer)
+  {
+    qDebug() << Q_FUNC_INFO << "no data container set";
+    return;
+  }
+  if (mTimeBinSize <= 0)
+  {
+    qDebug() << Q_FUNC_INFO << "invalid time bin size" << mTimeBinSize;
+    return;
+  }
+  
+  const double key = binKey(time);
+  if (mContainer->isEmpty() || key > (mContainer->constEnd()-1)->key) // sample starts a new bin
+  {
+    mContainer->add(QCPFinancialData(key, value, value, value, value));
+  } else if (key == (mContainer->constEnd()-1)->key) // sample continues the current bin
+  {
+    QCPFinancialDataContainer::iterator bin = mContainer->end()-1;
+    if (value > bin->high) bin->high = value;
+    if (value < bin->low) bin->low = value;
+    bin->close = value;
+  } else // late sample for an earlier bin
+  {
+    const int binIndex = int(mContainer->findBegin(key, false)-mContainer->constBegin());
+    if (binIndex < mContainer->size() && (mContainer->constBegin()+binIndex)->key == key)
+    {
+      QCPFinancialDataContainer::iterator bin = mContainer->begin()+binIndex;
+      if (value > bin->high) bin->high = value;
+      if (value < bin->low) bin->low = value;
+    } else
+      mContainer->add(QCPFinancialData(key, value, value, value, value));
+  }
+}
+
+/*!
+  Adds the samples given by \a time and \a value in the given order, see \ref addSample. If the
+  vectors differ in size, only the common number of samples is added.
+*/
+void QCPOhlcAggregator::addSamples(const QVector<double> &time, const QVector<double> &value)
+{
+  const int count = qMin(time.size(), value.size());
+  for (int i=0; i<count; ++i)
+    addSample(time.at(i), value.at(i));
+}
 /* end of 'src/plottables/plottable-financial.cpp' */
 
 
@@ -28343,6 +32618,10 @@ void QCPErrorBars::draw(QCPPainter *painter)
   }
 #endif
   
+  // error bars are culled per pixel column if there are at least two per pixel on average:
+  QCPAxis *orthoAxis = mErrorType == etValueError ? mKeyAxis.data() : mValueAxis.data();
+  const int cullingThreshold = 2*(orthoAxis->orientation() == Qt::Horizontal ? orthoAxis->axisRect()->width() : orthoAxis->axisRect()->height());
+  
   applyDefaultAntialiasingHint(painter);
   painter->setBrush(Qt::NoBrush);
   // loop over and draw segments of unselected/selected data:
@@ -28370,13 +32649,19 @@ void QCPErrorBars::draw(QCPPainter *painter)
     }
     backbones.clear();
     whiskers.clear();
+    int errorBarCount = 0;
     for (QCPErrorBarsDataContainer::const_iterator it=begin; it!=end; ++it)
     {
       if (!checkPointVisibility || errorBarVisible(int(it-mDataContainer->constBegin())))
+      {
         getErrorBarLines(it, backbones, whiskers);
+        ++errorBarCount;
+      }
     }
+    if (errorBarCount >= cullingThreshold)
+      cullErrorBarLines(backbones, whiskers);
+    backbones << whiskers;
     painter->drawLines(backbones);
-    painter->drawLines(whiskers);
   }
   
   // draw other selection decoration that isn't just line/scatter pens and brushes:
@@ -28793,6 +33078,83 @@ bool QCPErrorBars::errorBarVisible(int index) const
   return ((keyMax > mKeyAxis->range().lower) && (keyMin < mKeyAxis->range().upper));
 }
 
+/*! \internal
+
+  Reduces the error bar lines generated by \ref getErrorBarLines to one representative per pixel
+  column, preserving the envelope of the error bars. Consecutive lines are considered to be in the
+  same column if their position on the axis orthogonal to the error axis falls into the same
+  pixel.
+
+  The \a backbones of a column are replaced by the union of their intervals, so the covered pixels
+  (including gaps left by \ref setSymbolGap) stay the same. Of the \a whiskers of a column, only
+  the two outermost ones are kept, since the inner ones are hidden in the dense bundle of error
+  bars anyway.
+
+  Called by \ref draw when there are at least two error bars per pixel on average.
+*/
+void QCPErrorBars::cullErrorBarLines(QVector<QLineF> &backbones, QVector<QLineF> &whiskers) const
+{
+  QCPAxis *errorAxis = mErrorType == etValueError ? mValueAxis.data() : mKeyAxis.data();
+  const bool errorVertical = errorAxis->orientation() == Qt::Vertical;
+  
+  // merge the backbones of each column into the union of their intervals along the error axis:
+  QVector<QLineF> culledBackbones;
+  QVector<QCPRange> intervals;
+  int i = 0;
+  while (i < backbones.size())
+  {
+    const double ortho = errorVertical ? backbones.at(i).x1() : backbones.at(i).y1();
+    const int column = qFloor(ortho);
+    intervals.clear();
+    for (; i < backbones.size(); ++i)
+    {
+      const QLineF &line = backbones.at(i);
+      if (qFloor(errorVertical ? line.x1() : line.y1()) != column)
+        break;
+      intervals.append(errorVertical ? QCPRange(line.y1(), line.y2()) : QCPRange(line.x1(), line.x2()));
+    }
+    std::sort(intervals.begin(), intervals.end(), [](const QCPRange &a, const QCPRange &b) { return a.lower < b.lower; });
+    QCPRange merged = intervals.first();
+    for (int k=1; k<=intervals.size(); ++k)
+    {
+      if (k < intervals.size() && intervals.at(k).lower <= merged.upper)
+      {
+        merged.upper = qMax(merged.upper, intervals.at(k).upper);
+      } else
+      {
+        culledBackbones.append(errorVertical ? QLineF(ortho, merged.lower, ortho, merged.upper) : QLineF(merged.lower, ortho, merged.upper, ortho));
+        if (k < intervals.size())
+          merged = intervals.at(k);
+      }
+    }
+  }
+  backbones = culledBackbones;
+  
+  // keep only the outermost whiskers of each column:
+  QVector<QLineF> culledWhiskers;
+  i = 0;
+  while (i < whiskers.size())
+  {
+    const int column = qFloor(errorVertical ? whiskers.at(i).center().x() : whiskers.at(i).center().y());
+    int lowest = i, highest = i;
+    for (++i; i < whiskers.size(); ++i)
+    {
+      const QLineF &line = whiskers.at(i);
+      if (qFloor(errorVertical ? line.center().x() : line.center().y()) != column)
+        break;
+      const double position = errorVertical ? line.y1() : line.x1();
+      if (position < (errorVertical ? whiskers.at(lowest).y1() : whiskers.at(lowest).x1()))
+        lowest = i;
+      if (position > (errorVertical ? whiskers.at(highest).y1() : whiskers.at(highest).x1()))
+        highest = i;
+    }
+    culledWhiskers.append(whiskers.at(lowest));
+    if (highest != lowest)
+      culledWhiskers.append(whiskers.at(highest));
+  }
+  whiskers = culledWhiskers;
+}
+
 /*! \internal
 
   Returns whether \a line intersects (or is contained in) \a pixelRect.
@@ -28816,6 +33178,774 @@ bool QCPErrorBars::rectIntersectsLine(const QRectF &pixelRect, const QLineF &lin
 /* end of 'src/plottables/plottable-errorbar.cpp' */
 
 
+/* including file 'src/plottables/plottable-mappedgraph.cpp' */
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////// QCPMappedGraph
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/*! \class QCPMappedGraph
+  \brief A graph plottable that reads its data directly from a memory-mapped file
+
+  \ref QCPGraph keeps its data in a \ref QCPDataContainer, so a capture must be loaded into memory
+  completely before it can be plotted. \ref QCPMappedGraph instead maps a binary column file into
+  the address space (see \ref open) and reads keys and values directly from the mapping, without
+  copying them. This allows opening and panning captures of several gigabytes: The resident memory
+  stays close to the pages touched by the currently visible data, and the operating system's page
+  cache decides which parts of the file are kept in memory.
+
+  The file holds the keys and the values as two columns of \c double in native byte order. The keys
+  must be sorted ascendingly and must not be NaN. Values may be NaN to create gaps in the line. The
+  file must not be modified or truncated while it is mapped.
+
+  Since the plottable implements the \ref QCPPlottableInterface1D, data selection and for example
+  \ref QCPErrorBars work as with the other one-dimensional plottables.
+
+  \section qcpmappedgraph-drawing Drawing
+
+  The data is drawn as a line (\ref setLineVisible) and optionally with scatter symbols (\ref
+  setScatterStyle), which are placed on the points of the line. If more than two data points fall on
+  one pixel of the key axis, they are reduced to their first, minimum, maximum and last value, as
+  \ref QCPGraph::setAdaptiveSampling does.
+
+  To avoid reading every data point of the file when zoomed out, the value range of each block of
+  4096 consecutive data points is determined when the block is first needed, and is then kept in
+  memory (16 bytes per block). Pixels that cover entire blocks only read these summaries, and the
+  data points of the partially covered blocks at their ends.
+*/
+
+/* start of documentation of inline functions */
+
+/*! \fn QString QCPMappedGraph::fileName() const
+
+  Returns the name of the file opened with \ref open, or an empty string if no file was opened.
+*/
+
+/*! \fn bool QCPMappedGraph::isOpen() const
+
+  Returns whether a file is currently mapped, see \ref open.
+*/
+
+/* end of documentation of inline functions */
+
+/*! \internal
+  Number of data points summarized by one entry of \ref QCPMappedGraph::mBlockValueRanges.
+*/
+static const int qcpMappedGraphBlockSize = 4096;
+
+/*!
+  Constructs a mapped graph which uses \a keyAxis as its key axis ("x") and \a valueAxis as its
+  value axis ("y"). \a keyAxis and \a valueAxis must reside in the same QCustomPlot instance and not
+  have the same orientation. If either of these restrictions is violated, a corresponding message
+  is printed to the debug output (qDebug), the construction is not aborted, though.
+
+  The created \ref QCPMappedGraph is automatically registered with the QCustomPlot instance inferred
+  from \a keyAxis. This QCustomPlot instance takes ownership of the \ref QCPMappedGraph, so do not
+  delete it manually but use \ref QCustomPlot::removePlottable() instead.
+
+  Call \ref open to provide the data.
+*/
+QCPMappedGraph::QCPMappedGraph(QCPAxis *keyAxis, QCPAxis *valueAxis) :
+  QCPAbstractPlottable(keyAxis, valueAxis),
+  mLineVisible(true),
+  mMap(nullptr),
+  mKeys(nullptr),
+  mValues(nullptr),
+  mCount(0)
+{
+  setPen(QPen(Qt::blue, 0));
+  setBrush(Qt::NoBrush);
+}
+
+QCPMappedGraph::~QCPMappedGraph()
+{
+  // mFile unmaps the file when it is destroyed
+}
+
+/*!
+  Sets whether the data points are connected by a line, drawn with the current pen (\ref setPen).
+
+  \see setScatterStyle
+*/
+void QCPMappedGraph::setLineVisible(bool visible)
+{
+  mLineVisible = visible;
+}
+
+/*!
+  Sets the visual appearance of the data points. If set to \ref QCPScatterStyle::ssNone, no scatter
+  points are drawn.
+
+  If multiple data points fall on one pixel, the scatters are drawn at the reduced points of the
+  line only (see the \ref qcpmappedgraph-drawing "class documentation").
+
+  \see setLineVisible
+*/
+void QCPMappedGraph::setScatterStyle(const QCPScatterStyle &style)
+{
+  mScatterStyle = style;
+}
+
+/*! \overload
+
+  Maps the file \a fileName which consists only of the key column followed by the value column of
+  equal length, so the number of data points is the file size divided by <tt>2*sizeof(double)</tt>.
+
+  Returns true on success.
+*/
+bool QCPMappedGraph::open(const QString &fileName)
+{
+  const qint64 pointBytes = qint64(2*sizeof(double));
+  const qint64 fileSize = QFile(fileName).size();
+  if (fileSize <= 0 || fileSize % pointBytes != 0)
+  {
+    qDebug() << Q_FUNC_INFO << "file size isn't a positive multiple of" << pointBytes << "bytes:" << fileName;
+    return false;
+  }
+  if (fileSize/pointBytes > (std::numeric_limits<int>::max)())
+  {
+    qDebug() << Q_FUNC_INFO << "file holds too many data points:" << fileName;
+    return false;
+  }
+  const int count = int(fileSize/pointBytes);
+  return open(fileName, 0, qint64(count)*qint64(sizeof(double)), count);
+}
+
+/*!
+  Maps the file \a fileName, and uses the \a count doubles starting at byte \a keyColumnOffset as
+  keys and the \a count doubles starting at byte \a valueColumnOffset as values. The offsets must be
+  multiples of <tt>sizeof(double)</tt>. Any other contents of the file, such as headers or further
+  columns, are ignored.
+
+  A previously opened file is closed, and the selection is cleared.
+
+  Only the address space for the columns is reserved. The data is read from disk by the operating
+  system as the plottable accesses it, and stays in the page cache for as long as memory permits.
+
+  Returns true on success. On failure, a message is printed to the debug output (qDebug) and the
+  graph is left without data.
+
+  \see close
+*/
+bool QCPMappedGraph::open(const QString &fileName, qint64 keyColumnOffset, qint64 valueColumnOffset, int count)
+{
+  close();
+  if (count <= 0 || keyColumnOffset < 0 || valueColumnOffset < 0)
+  {
+    qDebug() << Q_FUNC_INFO << "invalid column layout" << keyColumnOffset << valueColumnOffset << count;
+    return false;
+  }
+  if (keyColumnOffset % qint64(sizeof(double)) != 0 || valueColumnOffset % qint64(sizeof(double)) != 0)
+  {
+    qDebug() << Q_FUNC_INFO << "column offsets must be multiples of" << sizeof(double) << "bytes";
+    return false;
+  }
+  
+  const qint64 columnBytes = qint64(count)*qint64(sizeof(double));
+  const qint64 mapBegin = qMin(keyColumnOffset, valueColumnOffset);
+  const qint64 mapEnd = qMax(keyColumnOffset, valueColumnOffset)+columnBytes;
+  mFile.setFileName(fileName);
+  if (!mFile.open(QIODevice::ReadOnly))
+  {
+    qDebug() << Q_FUNC_INFO << "can't open file" << fileName << mFile.errorString();
+    return false;
+  }
+  if (mFile.size() < mapEnd)
+  {
+    qDebug() << Q_FUNC_INFO << "file is too small for the column layout:" << fileName;
+    mFile.close();
+    return false;
+  }
+  mMap = mFile.map(mapBegin, mapEnd-mapBegin);
+  mFile.close(); // the mapping stays valid without the open file handle
+  if (!mMap)
+  {
+    qDebug() << Q_FUNC_INFO << "can't map file" << fileName << mFile.errorString();
+    return false;
+  }
+  
+  mKeys = reinterpret_cast<const double*>(mMap+(keyColumnOffset-mapBegin));
+  mValues = reinterpret_cast<const double*>(mMap+(valueColumnOffset-mapBegin));
+  mCount = count;
+  const int blockCount = (count+qcpMappedGraphBlockSize-1)/qcpMappedGraphBlockSize;
+  mBlockValueRanges.fill(QCPRange(), blockCount);
+  mBlockValueRangesValid.fill(false, blockCount);
+  return true;
+}
+
+/*!
+  Unmaps the currently opened file and clears the selection. The graph is left without data.
+
+  \see open
+*/
+void QCPMappedGraph::close()
+{
+  if (mMap)
+    mFile.unmap(mMap);
+  mMap = nullptr;
+  mKeys = nullptr;
+  mValues = nullptr;
+  mCount = 0;
+  mBlockValueRanges.clear();
+  mBlockValueRangesValid.clear();
+  if (!mSelection.isEmpty())
+    setSelection(QCPDataSelection());
+}
+
+/* inherits documentation from base class */
+int QCPMappedGraph::dataCount() const
+{
+  return mCount;
+}
+
+/* inherits documentation from base class */
+double QCPMappedGraph::dataMainKey(int index) const
+{
+  if (index >= 0 && index < mCount)
+    return mKeys[index];
+  qDebug() << Q_FUNC_INFO << "Index out of bounds" << index;
+  return 0;
+}
+
+/* inherits documentation from base class */
+double QCPMappedGraph::dataSortKey(int index) const
+{
+  return dataMainKey(index);
+}
+
+/* inherits documentation from base class */
+double QCPMappedGraph::dataMainValue(int index) const
+{
+  if (index >= 0 && index < mCount)
+    return mValues[index];
+  qDebug() << Q_FUNC_INFO << "Index out of bounds" << index;
+  return 0;
+}
+
+/* inherits documentation from base class */
+QCPRange QCPMappedGraph::dataValueRange(int index) const
+{
+  const double value = dataMainValue(index);
+  return {value, value};
+}
+
+/* inherits documentation from base class */
+QPointF QCPMappedGraph::dataPixelPosition(int index) const
+{
+  if (index >= 0 && index < mCount)
+    return coordsToPixels(mKeys[index], mValues[index]);
+  qDebug() << Q_FUNC_INFO << "Index out of bounds" << index;
+  return {};
+}
+
+/* inherits documentation from base class */
+bool QCPMappedGraph::sortKeyIsMainKey() const
+{
+  return true;
+}
+
+/*!
+  \copydoc QCPPlottableInterface1D::selectTestRect
+*/
+QCPDataSelection QCPMappedGraph::selectTestRect(const QRectF &rect, bool onlySelectable) const
+{
+  QCPDataSelection result;
+  if ((onlySelectable && mSelectable == QCP::stNone) || mCount == 0)
+    return result;
+  if (!mKeyAxis || !mValueAxis)
+    return result;
+  
+  // convert rect given in pixels to ranges given in plot coordinates:
+  double key1, value1, key2, value2;
+  pixelsToCoords(rect.topLeft(), key1, value1);
+  pixelsToCoords(rect.bottomRight(), key2, value2);
+  QCPRange keyRange(key1, key2); // QCPRange normalizes internally so we don't have to care about whether key1 < key2
+  QCPRange valueRange(value1, value2);
+  const int begin = findBegin(keyRange.lower, false);
+  const int end = findEnd(keyRange.upper, false);
+  
+  int currentSegmentBegin = -1; // -1 means we're currently not in a segment that's contained in rect
+  for (int i=begin; i<end; ++i)
+  {
+    if (currentSegmentBegin == -1)
+    {
+      if (valueRange.contains(mValues[i])) // start segment
+        currentSegmentBegin = i;
+    } else if (!valueRange.contains(mValues[i])) // segment just ended
+    {
+      result.addDataRange(QCPDataRange(currentSegmentBegin, i), false);
+      currentSegmentBegin = -1;
+    }
+  }
+  // process potential last segment:
+  if (currentSegmentBegin != -1)
+    result.addDataRange(QCPDataRange(currentSegmentBegin, end), false);
+  
+  result.simplify();
+  return result;
+}
+
+/* inherits documentation from base class */
+int QCPMappedGraph::findBegin(double sortKey, bool expandedRange) const
+{
+  if (mCount == 0)
+    return 0;
+  int index = int(std::lower_bound(mKeys, mKeys+mCount, sortKey)-mKeys);
+  if (expandedRange && index > 0)
+    --index;
+  return index;
+}
+
+/* inherits documentation from base class */
+int QCPMappedGraph::findEnd(double sortKey, bool expandedRange) const
+{
+  if (mCount == 0)
+    return 0;
+  int index = int(std::upper_bound(mKeys, mKeys+mCount, sortKey)-mKeys);
+  if (expandedRange && index < mCount)
+    ++index;
+  return index;
+}
+
+/*!
+  Implements a selectTest specific to this plottable's point geometry.
+
+  If \a details is not 0, it will be set to a \ref QCPDataSelection, describing the closest data
+  point to \a pos.
+  
+  \seebaseclassmethod \ref QCPAbstractPlottable::selectTest
+*/
+double QCPMappedGraph::selectTest(const QPointF &pos, bool onlySelectable, QVariant *details) const
+{
+  if ((onlySelectable && mSelectable == QCP::stNone) || mCount == 0)
+    return -1;
+  if (!mKeyAxis || !mValueAxis)
+    return -1;
+  
+  if (mKeyAxis.data()->axisRect()->rect().contains(pos.toPoint()) || mParentPlot->interactions().testFlag(QCP::iSelectPlottablesBeyondAxisRect))
+  {
+    int closestIndex = -1;
+    double result = pointDistance(pos, closestIndex);
+    if (details && closestIndex >= 0)
+      details->setValue(QCPDataSelection(QCPDataRange(closestIndex, closestIndex+1)));
+    return result;
+  } else
+    return -1;
+}
+
+/* inherits documentation from base class */
+QCPRange QCPMappedGraph::getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain) const
+{
+  foundRange = false;
+  if (mCount == 0)
+    return {};
+  
+  // keys are sorted, so each sign domain is a contiguous index range:
+  int begin = 0;
+  int end = mCount;
+  if (inSignDomain == QCP::sdPositive)
+    begin = int(std::upper_bound(mKeys, mKeys+mCount, 0.0)-mKeys);
+  else if (inSignDomain == QCP::sdNegative)
+    end = int(std::lower_bound(mKeys, mKeys+mCount, 0.0)-mKeys);
+  if (begin >= end)
+    return {};
+  foundRange = true;
+  return {mKeys[begin], mKeys[end-1]};
+}
+
+/*!
+  \copydoc QCPAbstractPlottable::getValueRange
+
+  For \ref QCP::sdBoth, this uses the block summaries described in the \ref
+  qcpmappedgraph-drawing "class documentation". So only the first call without key range
+  restriction reads the entire file.
+*/
+QCPRange QCPMappedGraph::getValueRange(bool &foundRange, QCP::SignDomain inSignDomain, const QCPRange &inKeyRange) const
+{
+  foundRange = false;
+  if (mCount == 0)
+    return {};
+  
+  int begin = 0;
+  int end = mCount;
+  if (inKeyRange != QCPRange())
+  {
+    begin = findBegin(inKeyRange.lower, false);
+    end = findEnd(inKeyRange.upper, false);
+  }
+  
+  QCPRange range;
+  if (inSignDomain == QCP::sdBoth)
+  {
+    range = valueSpan(begin, end);
+  } else
+  {
+    range.lower = std::numeric_limits<double>::infinity();
+    range.upper = -std::numeric_limits<double>::infinity();
+    for (int i=begin; i<end; ++i)
+    {
+      const double current = mValues[i];
+      if ((inSignDomain == QCP::sdNegative && current < 0) || (inSignDomain == QCP::sdPositive && current > 0))
+      {
+        if (current < range.lower)
+          range.lower = current;
+        if (current > range.upper)
+          range.upper = current;
+      }
+    }
+  }
+  foundRange = range.lower <= range.upper;
+  return foundRange ? range : QCPRange();
+}
+
+/* inherits documentation from base class */
+void QCPMappedGraph::draw(QCPPainter *painter)
+{
+  if (!mKeyAxis || !mValueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return; }
+  if (mKeyAxis.data()->range().size() <= 0 || mCount == 0) return;
+  if (!mLineVisible && mScatterStyle.isNone()) return;
+  
+  QVector<QPointF> lines; // line pixel coordinates will be stored here while iterating over segments
+  
+  // loop over and draw segments of unselected/selected data:
+  QList<QCPDataRange> selectedSegments, unselectedSegments, allSegments;
+  getDataSegments(selectedSegments, unselectedSegments);
+  allSegments << unselectedSegments << selectedSegments;
+  for (int i=0; i<allSegments.size(); ++i)
+  {
+    bool isSelectedSegment = i >= unselectedSegments.size();
+    
+    // draw line:
+    if (mLineVisible)
+    {
+      QCPDataRange lineDataRange = isSelectedSegment ? allSegments.at(i) : allSegments.at(i).adjusted(-1, 1); // unselected segments extend lines to bordering selected data point (getLines bounds it to the data)
+      getLines(&lines, lineDataRange);
+      if (isSelectedSegment && mSelectionDecorator)
+        mSelectionDecorator->applyPen(painter);
+      else
+        painter->setPen(mPen);
+      painter->setBrush(Qt::NoBrush);
+      if (painter->pen().style() != Qt::NoPen && painter->pen().color().alpha() != 0)
+      {
+        applyDefaultAntialiasingHint(painter);
+        drawPolyline(painter, lines);
+      }
+    }
+    
+    // draw scatters:
+    QCPScatterStyle finalScatterStyle = mScatterStyle;
+    if (isSelectedSegment && mSelectionDecorator)
+      finalScatterStyle = mSelectionDecorator->getFinalScatterStyle(mScatterStyle);
+    if (!finalScatterStyle.isNone())
+    {
+      if (!mLineVisible || !isSelectedSegment) // the line points don't match the segment exactly
+        getLines(&lines, allSegments.at(i));
+      applyScattersAntialiasingHint(painter);
+      finalScatterStyle.applyTo(painter, mPen);
+      finalScatterStyle.drawShapes(painter, lines, scatterSpriteCache(painter));
+    }
+  }
+  
+  // draw other selection decoration that isn't just line/scatter pens and brushes:
+  if (mSelectionDecorator)
+    mSelectionDecorator->drawDecoration(painter, selection());
+}
+
+/* inherits documentation from base class */
+void QCPMappedGraph::drawLegendIcon(QCPPainter *painter, const QRectF &rect) const
+{
+  // draw line vertically centered:
+  if (mLineVisible)
+  {
+    applyDefaultAntialiasingHint(painter);
+    painter->setPen(mPen);
+    painter->drawLine(QLineF(rect.left(), rect.top()+rect.height()/2.0, rect.right()+5, rect.top()+rect.height()/2.0)); // +5 on x2 else last segment is missing from dashed/dotted pens
+  }
+  // draw scatter symbol:
+  if (!mScatterStyle.isNone())
+  {
+    applyScattersAntialiasingHint(painter);
+    mScatterStyle.applyTo(painter, mPen);
+    mScatterStyle.drawShape(painter, QRectF(rect).center());
+  }
+}
+
+/*! \internal
+
+  Returns via \a lines the pixel coordinates of the line through the visible data points within \a
+  dataRange. The visible data points are determined by binary search in the mapped key column, so
+  only the visible part of the file is accessed.
+
+  If the visible data has more than two data points per pixel on average, the data points of each
+  pixel along the key axis are reduced to four line points: the first value, the minimum, the
+  maximum and the last value. The minimum and maximum are determined with \ref valueSpan.
+*/
+void QCPMappedGraph::getLines(QVector<QPointF> *lines, const QCPDataRange &dataRange) const
+{
+  if (!lines) return;
+  lines->clear();
+  QCPAxis *keyAxis = mKeyAxis.data();
+  QCPAxis *valueAxis = mValueAxis.data();
+  if (!keyAxis || !valueAxis) { qDebug() << Q_FUNC_INFO << "invalid key or value axis"; return; }
+  if (mCount == 0) return;
+  
+  const int begin = qMax(findBegin(keyAxis->range().lower), dataRange.begin());
+  const int end = qMin(findEnd(keyAxis->range().upper), dataRange.end());
+  if (begin >= end) return;
+  
+  const double keyPixelSpan = qAbs(keyAxis->coordToPixel(mKeys[begin])-keyAxis->coordToPixel(mKeys[end-1]));
+  if (end-begin < 2*keyPixelSpan+2) // less than two points per pixel on average, transfer points one-to-one
+  {
+    const int count = end-begin;
+    QVector<double> keyPixels(count), valuePixels(count);
+    keyAxis->coordsToPixels(mKeys+begin, keyPixels.data(), count);
+    valueAxis->coordsToPixels(mValues+begin, valuePixels.data(), count);
+    const double *x = keyAxis->orientation() == Qt::Vertical ? valuePixels.constData() : keyPixels.constData();
+    const double *y = keyAxis->orientation() == Qt::Vertical ? keyPixels.constData() : valuePixels.constData();
+    lines->resize(count);
+    QPointF *linePoint = lines->data();
+    for (int i=0; i<count; ++i)
+      *linePoint++ = QPointF(x[i], y[i]);
+    return;
+  }
+  
+  lines->reserve(int(qMin(double(end-begin), 4*keyPixelSpan+8)));
+  const int reversedFactor = keyAxis->pixelOrientation(); // is used to step one pixel into the direction of increasing keys
+  const int reversedRound = reversedFactor==-1 ? 1 : 0; // is used to switch between floor (normal) and ceil (reversed) rounding of intervalStartKey
+  int i = begin;
+  while (i < end)
+  {
+    const double intervalStartKey = keyAxis->pixelToCoord(int(keyAxis->coordToPixel(mKeys[i])+reversedRound));
+    const double intervalEndKey = keyAxis->pixelToCoord(keyAxis->coordToPixel(intervalStartKey)+1.0*reversedFactor);
+    const int intervalEnd = int(std::lower_bound(mKeys+i+1, mKeys+end, intervalEndKey)-mKeys); // at least i+1, so the loop always advances
+    if (intervalEnd-i == 1)
+    {
+      lines->append(coordsToPixels(mKeys[i], mValues[i]));
+    } else // pixel has multiple data points, consolidate them to a cluster
+    {
+      const double keyEpsilon = intervalEndKey-intervalStartKey;
+      const QCPRange span = valueSpan(i, intervalEnd);
+      lines->append(coordsToPixels(intervalStartKey+keyEpsilon*0.2, mValues[i]));
+      if (span.lower <= span.upper) // false if all values in this pixel are NaN
+      {
+        lines->append(coordsToPixels(intervalStartKey+keyEpsilon*0.25, span.lower));
+        lines->append(coordsToPixels(intervalStartKey+keyEpsilon*0.75, span.upper));
+      }
+      lines->append(coordsToPixels(intervalStartKey+keyEpsilon*0.8, mValues[intervalEnd-1]));
+    }
+    i = intervalEnd;
+  }
+}
+
+/*! \internal
+
+  Draws the line through the pixel coordinates \a lineData, where NaN points create gaps.
+
+  \note This method follows \ref QCPAbstractPlottable1D::drawPolyline but needs to be reproduced
+  here since \ref QCPMappedGraph doesn't store its data in a \ref QCPDataContainer and thus doesn't
+  derive from \ref QCPAbstractPlottable1D. See the documentation there for details.
+*/
+void QCPMappedGraph::drawPolyline(QCPPainter *painter, const QVector<QPointF> &lineData) const
+{
+  // reduce 1px lines to cosmetic when not exporting, see QCPAbstractPlottable1D::drawPolyline:
+  if (!painter->modes().testFlag(QCPPainter::pmVectorized) &&
+      qFuzzyCompare(painter->pen().widthF(), 1.0))
+  {
+    QPen newPen = painter->pen();
+    newPen.setWidth(0);
+    painter->setPen(newPen);
+  }
+  
+  const int lineDataSize = lineData.size();
+  // if drawing thin solid line onto an image, bypass QPainter and rasterize directly:
+  if (mParentPlot->plottingHints().testFlag(QCP::phRasterizeLines) &&
+      !painter->modes().testFlag(QCPPainter::pmVectorized))
+  {
+    QCPLineRasterizer rasterizer(painter);
+    if (rasterizer.isValid())
+    {
+      int segmentStart = 0;
+      for (int i=0; i<lineDataSize; ++i)
+      {
+        if (!qIsFinite(lineData.at(i).x()) || !qIsFinite(lineData.at(i).y())) // NaNs create a gap in the line, rasterizer also requires finite coordinates
+        {
+          rasterizer.drawPolyline(lineData.constData()+segmentStart, i-segmentStart);
+          segmentStart = i+1;
+        }
+      }
+      // draw last segment:
+      rasterizer.drawPolyline(lineData.constData()+segmentStart, lineDataSize-segmentStart);
+      return;
+    }
+  }
+  
+  int segmentStart = 0;
+  for (int i=0; i<lineDataSize; ++i)
+  {
+    if (qIsNaN(lineData.at(i).y()) || qIsNaN(lineData.at(i).x()) || qIsInf(lineData.at(i).y())) // NaNs create a gap in the line. Also filter Infs which make drawPolyline block
+    {
+      painter->drawPolyline(lineData.constData()+segmentStart, i-segmentStart); // i, because we don't want to include the current NaN point
+      segmentStart = i+1;
+    }
+  }
+  // draw last segment:
+  painter->drawPolyline(lineData.constData()+segmentStart, lineDataSize-segmentStart);
+}
+
+/*! \internal
+
+  Returns the range of the values of the data points from index \a begin up to (excluding) \a end,
+  ignoring NaN values. If there are no such values, the returned range has a lower bound greater
+  than its upper bound.
+
+  Blocks of data points which lie entirely within the index range aren't read, but represented by
+  their summary in \ref mBlockValueRanges, which is created upon first use.
+
+  \see scanValueSpan
+*/
+QCPRange QCPMappedGraph::valueSpan(int begin, int end) const
+{
+  QCPRange span;
+  span.lower = std::numeric_limits<double>::infinity();
+  span.upper = -std::numeric_limits<double>::infinity();
+  int i = begin;
+  while (i < end)
+  {
+    const int block = i/qcpMappedGraphBlockSize;
+    const int blockBegin = block*qcpMappedGraphBlockSize;
+    const int blockEnd = qMin(blockBegin+qcpMappedGraphBlockSize, mCount);
+    QCPRange current;
+    if (i == blockBegin && blockEnd <= end) // entire block is covered, use its summary
+    {
+      if (!mBlockValueRangesValid.testBit(block))
+      {
+        mBlockValueRanges[block] = scanValueSpan(blockBegin, blockEnd);
+        mBlockValueRangesValid.setBit(block);
+      }
+      current = mBlockValueRanges.at(block);
+    } else
+      current = scanValueSpan(i, qMin(blockEnd, end));
+    if (current.lower < span.lower)
+      span.lower = current.lower;
+    if (current.upper > span.upper)
+      span.upper = current.upper;
+    i = qMin(blockEnd, end);
+  }
+  return span;
+}
+
+/*! \internal
+
+  Reads the values of the data points from index \a begin up to (excluding) \a end and returns
+  their range, like \ref valueSpan, but without using block summaries.
+*/
+QCPRange QCPMappedGraph::scanValueSpan(int begin, int end) const
+{
+  QCPRange span;
+  span.lower = std::numeric_limits<double>::infinity();
+  span.upper = -std::numeric_limits<double>::infinity();
+  for (int i=begin; i<end; ++i)
+  {
+    const double current = mValues[i];
+    if (current < span.lower) // comparisons with NaN are false, so NaN values are skipped
+      span.lower = current;
+    if (current > span.upper)
+      span.upper = current;
+  }
+  return span;
+}
+
+/*! \internal
+
+  Calculates the minimum distance in pixels the graph's representation has from the given \a
+  pixelPoint. This is used to determine whether the graph was clicked or not, e.g. in \ref
+  selectTest. The closest data point to \a pixelPoint is returned in \a closestIndex, or -1 if
+  there is none.
+
+  Only the data points within the selection tolerance around \a pixelPoint are inspected. If these
+  are very many, their value span (see \ref valueSpan) is used instead of the single points.
+*/
+double QCPMappedGraph::pointDistance(const QPointF &pixelPoint, int &closestIndex) const
+{
+  closestIndex = -1;
+  if (mCount == 0)
+    return -1.0;
+  if (!mLineVisible && mScatterStyle.isNone())
+    return -1.0;
+  
+  double minDistSqr = (std::numeric_limits<double>::max)();
+  // determine which key range comes into question, taking selection tolerance around pos into account:
+  double posKey, posKeyMin, posKeyMax, dummy;
+  pixelsToCoords(pixelPoint, posKey, dummy);
+  pixelsToCoords(pixelPoint-QPointF(mParentPlot->selectionTolerance(), mParentPlot->selectionTolerance()), posKeyMin, dummy);
+  pixelsToCoords(pixelPoint+QPointF(mParentPlot->selectionTolerance(), mParentPlot->selectionTolerance()), posKeyMax, dummy);
+  if (posKeyMin > posKeyMax)
+    qSwap(posKeyMin, posKeyMax);
+  const int begin = findBegin(posKeyMin, true);
+  const int end = findEnd(posKeyMax, true);
+  if (end-begin <= qcpMappedGraphBlockSize)
+  {
+    for (int i=begin; i<end; ++i)
+    {
+      const double currentDistSqr = QCPVector2D(coordsToPixels(mKeys[i], mValues[i])-pixelPoint).lengthSquared();
+      if (currentDistSqr < minDistSqr)
+      {
+        minDistSqr = currentDistSqr;
+        closestIndex = i;
+      }
+    }
+  } else // too many data points near pixelPoint to visit each, so use the distance to their value span at posKey
+  {
+    closestIndex = qMin(findBegin(posKey, false), mCount-1);
+    const QCPRange span = valueSpan(begin, end);
+    if (span.lower <= span.upper)
+      minDistSqr = QCPVector2D(pixelPoint).distanceSquaredToLine(coordsToPixels(posKey, span.lower), coordsToPixels(posKey, span.upper));
+  }
+  
+  // calculate distance to graph line if there is one (if so, will probably be smaller than distance to closest data point):
+  if (mLineVisible)
+  {
+    QVector<QPointF> lineData;
+    getLines(&lineData, QCPDataRange(0, mCount)); // don't limit data range further since with sharp data spikes, line segments may be closer to test point than segments with closer key coordinate
+    QCPVector2D p(pixelPoint);
+    for (int i=0; i<lineData.size()-1; ++i)
+    {
+      const double currentDistSqr = p.distanceSquaredToLine(lineData.at(i), lineData.at(i+1));
+      if (currentDistSqr < minDistSqr)
+        minDistSqr = currentDistSqr;
+    }
+  }
+  
+  return qSqrt(minDistSqr);
+}
+
+/*! \internal
+
+  \note This method is identical to \ref QCPAbstractPlottable1D::getDataSegments but needs to be
+  reproduced here since \ref QCPMappedGraph doesn't derive from \ref QCPAbstractPlottable1D. See
+  the documentation there for details.
+*/
+void QCPMappedGraph::getDataSegments(QList<QCPDataRange> &selectedSegments, QList<QCPDataRange> &unselectedSegments) const
+{
+  selectedSegments.clear();
+  unselectedSegments.clear();
+  if (mSelectable == QCP::stWhole) // stWhole selection type draws the entire plottable with selected style if mSelection isn't empty
+  {
+    if (selected())
+      selectedSegments << QCPDataRange(0, dataCount());
+    else
+      unselectedSegments << QCPDataRange(0, dataCount());
+  } else
+  {
+    QCPDataSelection sel(selection());
+    sel.simplify();
+    selectedSegments = sel.dataRanges();
+    unselectedSegments = sel.inverse(QCPDataRange(0, dataCount())).dataRanges();
+  }
+}
+/* end of 'src/plottables/plottable-mappedgraph.cpp' */
+
+
 /* including file 'src/items/item-straightline.cpp' */
 /* modified 2021-03-29T02:30:44, size 7596          */
 
@@ -33087,7 +38217,8 @@ QCP::Interaction QCPPolarAxisAngular::selectionCategory() const
 void QCPPolarAxisAngular::setBackground(const QPixmap &pm)
 {
   mBackgroundPixmap = pm;
-  mScaledBackgroundPixmap = QPixmap();
+  mBackgroundImage = pm.toImage();
+  mScaledBackgroundImage = QImage();
 }
 
 /*! \overload
@@ -33118,7 +38249,8 @@ void QCPPolarAxisAngular::setBackground(const QBrush &brush)
 void QCPPolarAxisAngular::setBackground(const QPixmap &pm, bool scaled, Qt::AspectRatioMode mode)
 {
   mBackgroundPixmap = pm;
-  mScaledBackgroundPixmap = QPixmap();
+  mBackgroundImage = pm.toImage();
+  mScaledBackgroundImage = QImage();
   mBackgroundScaled = scaled;
   mBackgroundScaledMode = mode;
 }
@@ -33801,7 +38933,7 @@ void QCPPolarAxisAngular::setSelectedSubTickPen(const QPen &pen)
   Then, if a pixmap was provided via \ref setBackground, this function buffers the scaled version
   depending on \ref setBackgroundScaled and \ref setBackgroundScaledMode and then draws it inside
   the axis rect with the provided \a painter. The scaled version is buffered in
-  mScaledBackgroundPixmap to prevent expensive rescaling at every redraw. It is only updated, when
+  mScaledBackgroundImage to prevent expensive rescaling at every redraw. It is only updated, when
   the axis rect has changed in a way that requires a rescale of the background pixmap (this is
   dependent on the \ref setBackgroundScaledMode), or when a differend axis background pixmap was
   set.
@@ -33819,7 +38951,7 @@ void QCPPolarAxisAngular::drawBackground(QCPPainter *painter, const QPointF &cen
   }
   
   // draw background pixmap (on top of fill, if brush specified):
-  if (!mBackgroundPixmap.isNull())
+  if (!mBackgroundImage.isNull())
   {
     QRegion clipCircle(center.x()-radius, center.y()-radius, qRound(2*radius), qRound(2*radius), QRegion::Ellipse);
     QRegion originalClip = painter->clipRegion();
@@ -33827,14 +38959,14 @@ void QCPPolarAxisAngular::drawBackground(QCPPainter *painter, const QPointF &cen
     if (mBackgroundScaled)
     {
       // check whether mScaledBackground needs to be updated:
-      QSize scaledSize(mBackgroundPixmap.size());
+      QSize scaledSize(mBackgroundImage.size());
       scaledSize.scale(mRect.size(), mBackgroundScaledMode);
-      if (mScaledBackgroundPixmap.size() != scaledSize)
-        mScaledBackgroundPixmap = mBackgroundPixmap.scaled(mRect.size(), mBackgroundScaledMode, Qt::SmoothTransformation);
-      painter->drawPixmap(mRect.topLeft()+QPoint(0, -1), mScaledBackgroundPixmap, QRect(0, 0, mRect.width(), mRect.height()) & mScaledBackgroundPixmap.rect());
+      if (mScaledBackgroundImage.size() != scaledSize)
+        mScaledBackgroundImage = mBackgroundImage.scaled(mRect.size(), mBackgroundScaledMode, Qt::SmoothTransformation);
+      painter->drawImage(mRect.topLeft()+QPoint(0, -1), mScaledBackgroundImage, QRect(0, 0, mRect.width(), mRect.height()) & mScaledBackgroundImage.rect());
     } else
     {
-      painter->drawPixmap(mRect.topLeft()+QPoint(0, -1), mBackgroundPixmap, QRect(0, 0, mRect.width(), mRect.height()));
+      painter->drawImage(mRect.topLeft()+QPoint(0, -1), mBackgroundImage, QRect(0, 0, mRect.width(), mRect.height()));
     }
     painter->setClipRegion(originalClip);
   }
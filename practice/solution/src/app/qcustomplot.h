@@ -66,9 +66,19 @@
 #include <QtCore/QStack>
 #include <QtCore/QCache>
 #include <QtCore/QMargins>
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
+#include <QtCore/QRunnable>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QFile>
+#include <QtCore/QBitArray>
+#include <QtGui/QImage>
+#include <QtGui/QFontDatabase>
 #include <qmath.h>
 #include <limits>
 #include <algorithm>
+#include <functional>
 #ifdef QCP_OPENGL_FBO
 #  include <QtGui/QOpenGLContext>
 #  if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -127,6 +137,7 @@ class QCPPolarAxisRadial;
 class QCPPolarAxisAngular;
 class QCPPolarGrid;
 class QCPPolarGraph;
+class QCPRenderThread;
 
 /* including file 'src/global.h'            */
 /* modified 2021-03-29T02:30:44, size 16981 */
@@ -241,6 +252,18 @@ enum PlottingHint { phNone              = 0x000 ///< <tt>0x000</tt> No hints are
                     ,phImmediateRefresh = 0x002 ///< <tt>0x002</tt> causes an immediate repaint() instead of a soft update() when QCustomPlot::replot() is called with parameter \ref QCustomPlot::rpRefreshHint.
                                                 ///<                This is set by default to prevent the plot from freezing on fast consecutive replots (e.g. user drags ranges with mouse).
                     ,phCacheLabels      = 0x004 ///< <tt>0x004</tt> axis (tick) labels will be cached as pixmaps, increasing replot performance.
+                    ,phSkipStaticLayers = 0x008 ///< <tt>0x008</tt> If the viewport, axis rects and axis ranges are unchanged since the last replot, only paint buffers holding plottables or items are redrawn.
+                                                ///<                See \ref QCustomPlot::invalidateStaticLayers.
+                    ,phRasterizeLines   = 0x010 ///< <tt>0x010</tt> Paint buffers are based on QImage, and thin solid cosmetic lines of graphs and curves are rasterized directly into them
+                                                ///<                (see \ref QCPLineRasterizer) instead of being stroked by QPainter.
+                    ,phParallelGeometry = 0x020 ///< <tt>0x020</tt> Before painting, the pixel geometry (lines and scatter positions) of all visible graphs is computed concurrently
+                                                ///<                on a thread pool, so the painting only strokes the prepared polylines. See \ref QCPGraph::prepareGeometry.
+                    ,phCacheScatters    = 0x040 ///< <tt>0x040</tt> Scatter symbols of graphs and curves are rendered once per style into cached pixmaps, which are then stamped onto the plot
+                                                ///<                in batches. Exports keep drawing the symbols as vector shapes. See \ref QCPScatterStyle::drawShapes.
+                    ,phProgressiveInteraction = 0x080 ///< <tt>0x080</tt> While the user drags or zooms axis ranges, the last frame is shifted and scaled immediately, coarse frames follow at a
+                                                ///<                throttled rate, and the full replot once the input is idle. See \ref QCustomPlot::setProgressiveRefineDelay.
+                    ,phSkipLayout       = 0x100 ///< <tt>0x100</tt> If the viewport, the layout tree and the axis margins are unchanged since the last replot, the margin and layout passes
+                                                ///<                of \ref QCustomPlot::updateLayout are skipped. See \ref QCustomPlot::invalidateLayout.
                   };
 Q_DECLARE_FLAGS(PlottingHints, PlottingHint)
 
@@ -335,6 +358,18 @@ inline bool isInvalidData(double value1, double value2)
   return isInvalidData(value1) || isInvalidData(value2);
 }
 
+/*! \internal
+  
+  Returns a new, application-wide unique data revision number. Data containers take a new revision
+  whenever their data may have changed, so caches derived from the data (e.g. \ref QCPPointIndex)
+  can tell whether they're still up to date.
+*/
+inline quint64 nextDataRevision()
+{
+  static QBasicAtomicInteger<quint64> revisionCounter = Q_BASIC_ATOMIC_INITIALIZER(0);
+  return revisionCounter.fetchAndAddRelaxed(1)+1;
+}
+
 /*! \internal
   
   Sets the specified \a side of \a margins to \a value
@@ -518,6 +553,41 @@ Q_DECLARE_METATYPE(QCPPainter::PainterMode)
 /* end of 'src/painter.h' */
 
 
+/* including file 'src/linerasterizer.h'   */
+
+class QCP_LIB_DECL QCPLineRasterizer
+{
+public:
+  explicit QCPLineRasterizer(QCPPainter *painter);
+  
+  // getters:
+  bool isValid() const { return mImage; }
+  
+  // non-virtual methods:
+  void drawPolyline(const QPointF *points, int pointCount);
+  void drawLine(const QPointF &p1, const QPointF &p2, bool includeLast=true);
+  
+protected:
+  // non-property members:
+  QImage *mImage;
+  uchar *mBits;
+  int mBytesPerLine;
+  quint32 mColor;
+  bool mAntialiased;
+  double mScaleX, mScaleY, mDx, mDy;
+  QRect mClip;
+  QRectF mClipF;
+  
+  // non-virtual methods:
+  bool clipLine(double &x1, double &y1, double &x2, double &y2) const;
+  void drawLineAliased(double x1, double y1, double x2, double y2, bool includeLast);
+  void drawLineAntialiased(double x1, double y1, double x2, double y2, bool includeLast);
+  inline void blendPixel(int x, int y, int coverage);
+};
+
+/* end of 'src/linerasterizer.h' */
+
+
 /* including file 'src/paintbuffer.h'      */
 /* modified 2021-03-29T02:30:44, size 5006 */
 
@@ -576,6 +646,48 @@ protected:
 };
 
 
+class QCP_LIB_DECL QCPPaintBufferImage : public QCPAbstractPaintBuffer
+{
+public:
+  explicit QCPPaintBufferImage(const QSize &size, double devicePixelRatio);
+  virtual ~QCPPaintBufferImage() Q_DECL_OVERRIDE;
+  
+  // getters:
+  QImage &image() { return mBuffer; }
+  
+  // reimplemented virtual methods:
+  virtual QCPPainter *startPainting() Q_DECL_OVERRIDE;
+  virtual void draw(QCPPainter *painter) const Q_DECL_OVERRIDE;
+  void clear(const QColor &color) Q_DECL_OVERRIDE;
+  
+  // non-virtual methods:
+  QImage subImage(const QRect &deviceRect);
+  
+protected:
+  // non-property members:
+  QImage mBuffer;
+  
+  // reimplemented virtual methods:
+  virtual void reallocateBuffer() Q_DECL_OVERRIDE;
+};
+
+
+class QCPRasterJob : public QRunnable
+{
+public:
+  QCPRasterJob(const QImage &target, const QPoint &offset, const QList<QCPLayerable*> &layerables);
+  
+  // reimplemented virtual methods:
+  virtual void run() Q_DECL_OVERRIDE;
+  
+protected:
+  // non-property members:
+  QImage mTarget;
+  QPoint mOffset;
+  QList<QCPLayerable*> mLayerables;
+};
+
+
 #ifdef QCP_OPENGL_PBUFFER
 class QCP_LIB_DECL QCPPaintBufferGlPbuffer : public QCPAbstractPaintBuffer
 {
@@ -626,6 +738,82 @@ protected:
 /* end of 'src/paintbuffer.h' */
 
 
+/* including file 'src/profiler.h'         */
+
+class QCP_LIB_DECL QCPProfiler
+{
+public:
+  /*!
+    Holds one recorded time span, see \ref QCPProfiler::events.
+  */
+  struct Event
+  {
+    QString name;       ///< the stage, layer name or layerable description (see \ref QCPProfiler::layerableName)
+    QString category;   ///< one of "replot", "frame", "layout", "buffers", "geometry", "layer", "layerable" and "paint"
+    qint64 start;       ///< start time in nanoseconds since the profiler was created
+    qint64 duration;    ///< duration in nanoseconds
+    int thread;         ///< small integer identifying the thread the span was recorded in, 0 being the first thread seen
+  };
+  
+  QCPProfiler();
+  
+  // getters:
+  int maximumEvents() const { return mMaximumEvents; }
+  bool overlayVisible() const { return mOverlayVisible; }
+  
+  // setters:
+  void setMaximumEvents(int count);
+  void setOverlayVisible(bool visible);
+  
+  // non-property methods:
+  void record(const char *category, const QString &name, qint64 start, qint64 end);
+  qint64 now() const { return mClock.nsecsElapsed(); }
+  void beginFrame();
+  void endFrame();
+  QList<Event> events() const;
+  QList<Event> lastFrame() const;
+  void clear();
+  QByteArray toChromeTrace() const;
+  bool saveChromeTrace(const QString &fileName) const;
+  void drawOverlay(QPainter *painter, const QRect &rect) const;
+  static QString layerableName(const QCPLayerable *layerable);
+  
+protected:
+  // property members:
+  int mMaximumEvents;
+  bool mOverlayVisible;
+  
+  // non-property members:
+  QElapsedTimer mClock;
+  mutable QMutex mMutex;
+  QList<Event> mEvents;
+  QList<Event> mLastFrame;
+  qint64 mFrameStart;
+  QHash<Qt::HANDLE, int> mThreadIds;
+};
+Q_DECLARE_TYPEINFO(QCPProfiler::Event, Q_MOVABLE_TYPE);
+
+
+class QCP_LIB_DECL QCPProfileScope
+{
+public:
+  QCPProfileScope(QCPProfiler *profiler, const char *category, const QString &name);
+  QCPProfileScope(QCPProfiler *profiler, const QCPLayerable *layerable);
+  ~QCPProfileScope();
+  
+protected:
+  QCPProfiler *mProfiler;
+  const char *mCategory;
+  QString mName;
+  qint64 mStart;
+  
+private:
+  Q_DISABLE_COPY(QCPProfileScope)
+};
+
+/* end of 'src/profiler.h' */
+
+
 /* including file 'src/layer.h'            */
 /* modified 2021-03-29T02:30:44, size 7038 */
 
@@ -687,6 +875,7 @@ protected:
   // non-virtual methods:
   void draw(QCPPainter *painter);
   void drawToPaintBuffer();
+  bool hasDynamicContent() const;
   void addChild(QCPLayerable *layerable, bool prepend);
   void removeChild(QCPLayerable *layerable);
   
@@ -770,6 +959,7 @@ private:
   friend class QCustomPlot;
   friend class QCPLayer;
   friend class QCPAxisRect;
+  friend class QCPRasterJob;
 };
 
 /* end of 'src/layer.h' */
@@ -1711,11 +1901,25 @@ public:
   // introduced virtual methods:
   virtual void generate(const QCPRange &range, const QLocale &locale, QChar formatChar, int precision, QVector<double> &ticks, QVector<double> *subTicks, QVector<QString> *tickLabels);
   
+  // non-virtual methods:
+  void clearCache();
+  
 protected:
   // property members:
   TickStepStrategy mTickStepStrategy;
   int mTickCount;
   double mTickOrigin;
+  // non-property members:
+  bool mCacheValid;
+  QCPRange mCachedRange;
+  QLocale mCachedLocale;
+  QChar mCachedFormatChar;
+  int mCachedPrecision;
+  double mCachedTickStep;
+  bool mCachedSubTicksValid, mCachedTickLabelsValid;
+  QVector<double> mCachedTicks, mCachedSubTicks;
+  QVector<QString> mCachedTickLabels;
+  bool mReuseCachedLabels;
   
   // introduced virtual methods:
   virtual double getTickStep(const QCPRange &range);
@@ -1779,12 +1983,35 @@ protected:
 # endif
   // non-property members:
   enum DateStrategy {dsNone, dsUniformTimeInDay, dsUniformDayInMonth} mDateStrategy;
+  enum TimeField {tfHour, tfHour12, tfMinute, tfSecond, tfMillisecond};
+  struct TimeToken
+  {
+    TimeField field;
+    int width;
+  };
+  // state of the fast label formatter (see getTickLabel):
+  enum FastFormatState {ffsUnchecked, ffsValid, ffsInvalid} mFastFormatState;
+  QLocale mFastFormatLocale;
+  QString mDayFormat;
+  QVector<TimeToken> mTimeTokens;
+  bool mFormatHasAmPm;
+  QHash<qint64, QStringList> mDayLabelCache;
+  qint64 mOffsetBucket;
+  int mOffsetSeconds;
+  bool mOffsetValid;
   
   // reimplemented virtual methods:
   virtual double getTickStep(const QCPRange &range) Q_DECL_OVERRIDE;
   virtual int getSubTickCount(double tickStep) Q_DECL_OVERRIDE;
   virtual QString getTickLabel(double tick, const QLocale &locale, QChar formatChar, int precision) Q_DECL_OVERRIDE;
   virtual QVector<double> createTickVector(double tickStep, const QCPRange &range) Q_DECL_OVERRIDE;
+  
+  // non-virtual methods:
+  void resetFastFormat();
+  bool prepareFastFormat(const QLocale &locale);
+  QString slowTickLabel(double tick, const QLocale &locale) const;
+  int utcOffset(qint64 msecs);
+  QString fastTickLabel(double tick, const QLocale &locale);
 };
 
 /* end of 'src/axis/axistickerdatetime.h' */
@@ -1893,7 +2120,7 @@ public:
   QCPAxisTickerText();
   
   // getters:
-  QMap<double, QString> &ticks() { return mTicks; }
+  QMap<double, QString> &ticks() { clearCache(); return mTicks; } // ticks may be modified via the returned reference
   int subTickCount() const { return mSubTickCount; }
   
   // setters:
@@ -2265,6 +2492,7 @@ public:
   void rescale(bool onlyVisiblePlottables=false);
   double pixelToCoord(double value) const;
   double coordToPixel(double value) const;
+  void coordsToPixels(const double *coords, double *pixels, int count) const;
   SelectablePart getPartAt(const QPointF &pos) const;
   QList<QCPAbstractPlottable*> plottables() const;
   QList<QCPGraph*> graphs() const;
@@ -2427,6 +2655,7 @@ protected:
   QCustomPlot *mParentPlot;
   QByteArray mLabelParameterHash; // to determine whether mLabelCache needs to be cleared due to changed parameters
   QCache<QString, CachedLabel> mLabelCache;
+  mutable QCache<QString, TickLabelData> mLabelDataCache; // measured tick labels, valid for the same label parameters as mLabelCache
   QRect mAxisSelectionBox, mTickLabelsSelectionBox, mLabelSelectionBox;
   
   virtual QByteArray generateLabelParameterHash() const;
@@ -2436,6 +2665,9 @@ protected:
   virtual TickLabelData getTickLabelData(const QFont &font, const QString &text) const;
   virtual QPointF getTickLabelDrawOffset(const TickLabelData &labelData) const;
   virtual void getMaxTickLabelSize(const QFont &font, const QString &text, QSize *tickLabelsSize) const;
+  
+  // non-virtual methods:
+  TickLabelData cachedTickLabelData(const QFont &font, const QString &text) const;
 };
 
 /* end of 'src/axis/axis.h' */
@@ -2525,8 +2757,10 @@ public:
   bool isPenDefined() const { return mPenDefined; }
   void undefinePen();
   void applyTo(QCPPainter *painter, const QPen &defaultPen) const;
+  bool isOpaque(const QPen &defaultPen) const;
   void drawShape(QCPPainter *painter, const QPointF &pos) const;
   void drawShape(QCPPainter *painter, double x, double y) const;
+  void drawShapes(QCPPainter *painter, const QVector<QPointF> &positions, QCache<QByteArray, QPixmap> *spriteCache=nullptr) const;
 
 protected:
   // property members:
@@ -2539,6 +2773,13 @@ protected:
   
   // non-property members:
   bool mPenDefined;
+  
+  // non-virtual methods:
+  bool spritesApplicable(const QCPPainter *painter) const;
+  bool overdrawInvisible(const QCPPainter *painter) const;
+  QVector<QPointF> uniqueSpritePositions(const QCPPainter *painter, const QVector<QPointF> &positions, const QSize &spriteSize) const;
+  QByteArray spriteKey(const QCPPainter *painter, double ratio) const;
+  QPixmap createSprite(const QCPPainter *painter, double ratio) const;
 };
 Q_DECLARE_TYPEINFO(QCPScatterStyle, Q_MOVABLE_TYPE);
 Q_DECLARE_OPERATORS_FOR_FLAGS(QCPScatterStyle::ScatterProperties)
@@ -2551,6 +2792,85 @@ Q_DECLARE_METATYPE(QCPScatterStyle::ScatterShape)
 /* including file 'src/datacontainer.h'     */
 /* modified 2021-03-29T02:30:44, size 34070 */
 
+template <typename OffsetType>
+class QCPOffsetKey // no QCP_LIB_DECL, template class ends up in header
+{
+public:
+  QCPOffsetKey() : mOffset(0) {}
+  explicit QCPOffsetKey(double key) : mOffset(OffsetType(key-baseStorage())) {}
+  
+  operator double() const { return baseStorage()+double(mOffset); }
+  QCPOffsetKey &operator=(double key) { mOffset = OffsetType(key-baseStorage()); return *this; }
+  QCPOffsetKey &operator+=(double delta) { return *this = double(*this)+delta; }
+  QCPOffsetKey &operator-=(double delta) { return *this = double(*this)-delta; }
+  
+  static double base() { return baseStorage(); }
+  static void setBase(double base) { baseStorage() = base; }
+  
+private:
+  OffsetType mOffset;
+  
+  static double &baseStorage() { static double storage = 0; return storage; }
+};
+
+/*! \class QCPOffsetKey
+  \brief Stores a key as a low precision offset from an application-wide double precision base
+  
+  The key converts implicitly to double, and can be assigned from a double. So it can replace a
+  double key member of a data type (see \ref QCPGraphData), halving its size with \c float as \a
+  OffsetType, while keeping the resolution of keys which are large in magnitude but close to each
+  other, such as timestamps in seconds since epoch.
+  
+  The resolution of a \c float offset is relative to its distance from the base (24 bit mantissa).
+  For keys in seconds, the step between representable keys is:
+  \li 7.8 ms up to about 18 hours (2^16 s) from the base,
+  \li 15.6 ms up to about 1.5 days (2^17 s),
+  \li 0.25 s after about a month,
+  \li 2 s after about a year.
+  
+  So keys keep a resolution below 10 ms only within about 18 hours before or after the base. For
+  longer histories at that resolution, use the default double keys instead.
+  
+  The base is a single static value shared by all keys with the same \a OffsetType in the
+  application, not a per-container or per-plottable setting. It should be set once with \ref
+  setBase, before any data is added. Changing it later shifts all existing keys.
+*/
+
+/*! \typedef QCPDataKey
+  
+  The type of the key member of \ref QCPGraphData. This is \c double, unless the library is
+  compiled with \c QCP_SINGLE_PRECISION_DATA (\c float) or \c QCP_OFFSET_KEY_DATA (\ref
+  QCPOffsetKey<float>).
+  
+  Both defines are build-wide switches: they change the data types of all graphs and curves of
+  the application, so single and double precision plottables can't coexist. They must be defined
+  identically for the library and all code including this header.
+  
+  With \c QCP_SINGLE_PRECISION_DATA, keys are plain floats, whose step between representable
+  values grows with their magnitude. Timestamps in seconds since epoch (around 1.7e9) are only
+  resolved in steps of 128 s, so they must not be used as keys in this mode. Keys relative to the
+  start of a measurement have the resolution listed at \ref QCPOffsetKey. For epoch timestamps, use
+  \c QCP_OFFSET_KEY_DATA, within the limits described there, or the default double keys.
+*/
+
+/*! \typedef QCPDataValue
+  
+  The type of the value member of \ref QCPGraphData and all members of \ref QCPCurveData. This is
+  \c double, unless the library is compiled with \c QCP_SINGLE_PRECISION_DATA or \c
+  QCP_OFFSET_KEY_DATA, in which case it is \c float. Like \ref QCPDataKey, this is a build-wide
+  switch.
+*/
+#if defined(QCP_OFFSET_KEY_DATA)
+typedef QCPOffsetKey<float> QCPDataKey;
+typedef float QCPDataValue;
+#elif defined(QCP_SINGLE_PRECISION_DATA)
+typedef float QCPDataKey;
+typedef float QCPDataValue;
+#else
+typedef double QCPDataKey;
+typedef double QCPDataValue;
+#endif
+
 /*! \relates QCPDataContainer
   Returns whether the sort key of \a a is less than the sort key of \a b.
 
@@ -2572,6 +2892,7 @@ public:
   int size() const { return mData.size()-mPreallocSize; }
   bool isEmpty() const { return size() == 0; }
   bool autoSqueeze() const { return mAutoSqueeze; }
+  quint64 revision() const { return mRevision; }
   
   // setters:
   void setAutoSqueeze(bool enabled);
@@ -2592,8 +2913,8 @@ public:
   
   const_iterator constBegin() const { return mData.constBegin()+mPreallocSize; }
   const_iterator constEnd() const { return mData.constEnd(); }
-  iterator begin() { return mData.begin()+mPreallocSize; }
-  iterator end() { return mData.end(); }
+  iterator begin() { mRevision = QCP::nextDataRevision(); return mData.begin()+mPreallocSize; } // data may be modified via non-const iterators
+  iterator end() { mRevision = QCP::nextDataRevision(); return mData.end(); }
   const_iterator findBegin(double sortKey, bool expandedRange=true) const;
   const_iterator findEnd(double sortKey, bool expandedRange=true) const;
   const_iterator at(int index) const { return constBegin()+qBound(0, index, size()); }
@@ -2610,6 +2931,7 @@ protected:
   QVector<DataType> mData;
   int mPreallocSize;
   int mPreallocIteration;
+  quint64 mRevision;
   
   // non-virtual methods:
   void preallocateGrow(int minimumPreallocSize);
@@ -2756,7 +3078,8 @@ template <class DataType>
 QCPDataContainer<DataType>::QCPDataContainer() :
   mAutoSqueeze(true),
   mPreallocSize(0),
-  mPreallocIteration(0)
+  mPreallocIteration(0),
+  mRevision(QCP::nextDataRevision())
 {
 }
 
@@ -2804,6 +3127,7 @@ void QCPDataContainer<DataType>::set(const QCPDataContainer<DataType> &data)
 template <class DataType>
 void QCPDataContainer<DataType>::set(const QVector<DataType> &data, bool alreadySorted)
 {
+  mRevision = QCP::nextDataRevision();
   mData = data;
   mPreallocSize = 0;
   mPreallocIteration = 0;
@@ -2822,6 +3146,7 @@ void QCPDataContainer<DataType>::add(const QCPDataContainer<DataType> &data)
 {
   if (data.isEmpty())
     return;
+  mRevision = QCP::nextDataRevision();
   
   const int n = data.size();
   const int oldSize = size();
@@ -2854,6 +3179,7 @@ void QCPDataContainer<DataType>::add(const QVector<DataType> &data, bool already
 {
   if (data.isEmpty())
     return;
+  mRevision = QCP::nextDataRevision();
   if (isEmpty())
   {
     set(data, alreadySorted);
@@ -2889,6 +3215,7 @@ void QCPDataContainer<DataType>::add(const QVector<DataType> &data, bool already
 template <class DataType>
 void QCPDataContainer<DataType>::add(const DataType &data)
 {
+  mRevision = QCP::nextDataRevision();
   if (isEmpty() || !qcpLessThanSortKey<DataType>(data, *(constEnd()-1))) // quickly handle appends if new data key is greater or equal to existing ones
   {
     mData.append(data);
@@ -2987,6 +3314,7 @@ void QCPDataContainer<DataType>::remove(double sortKey)
 template <class DataType>
 void QCPDataContainer<DataType>::clear()
 {
+  mRevision = QCP::nextDataRevision();
   mData.clear();
   mPreallocIteration = 0;
   mPreallocSize = 0;
@@ -3534,6 +3862,7 @@ protected:
   // non-virtual methods:
   void applyFillAntialiasingHint(QCPPainter *painter) const;
   void applyScattersAntialiasingHint(QCPPainter *painter) const;
+  QCache<QByteArray, QPixmap> *scatterSpriteCache(const QCPPainter *painter) const;
 
 private:
   Q_DISABLE_COPY(QCPAbstractPlottable)
@@ -3747,6 +4076,7 @@ class QCP_LIB_DECL QCustomPlot : public QWidget
   Q_PROPERTY(bool autoAddPlottableToLegend READ autoAddPlottableToLegend WRITE setAutoAddPlottableToLegend)
   Q_PROPERTY(int selectionTolerance READ selectionTolerance WRITE setSelectionTolerance)
   Q_PROPERTY(bool noAntialiasingOnDrag READ noAntialiasingOnDrag WRITE setNoAntialiasingOnDrag)
+  Q_PROPERTY(int progressiveRefineDelay READ progressiveRefineDelay WRITE setProgressiveRefineDelay)
   Q_PROPERTY(Qt::KeyboardModifier multiSelectModifier READ multiSelectModifier WRITE setMultiSelectModifier)
   Q_PROPERTY(bool openGl READ openGl WRITE setOpenGl)
   /// \endcond
@@ -3789,11 +4119,15 @@ public:
   const QCP::Interactions interactions() const { return mInteractions; }
   int selectionTolerance() const { return mSelectionTolerance; }
   bool noAntialiasingOnDrag() const { return mNoAntialiasingOnDrag; }
+  int progressiveRefineDelay() const { return mProgressiveRefineDelay; }
   QCP::PlottingHints plottingHints() const { return mPlottingHints; }
   Qt::KeyboardModifier multiSelectModifier() const { return mMultiSelectModifier; }
   QCP::SelectionRectMode selectionRectMode() const { return mSelectionRectMode; }
   QCPSelectionRect *selectionRect() const { return mSelectionRect; }
   bool openGl() const { return mOpenGl; }
+  bool parallelRasterization() const { return mParallelRasterization; }
+  QCPRenderThread *renderThread() const { return mRenderThread; }
+  QCPProfiler *profiler() const { return mProfiler; }
   
   // setters:
   void setViewport(const QRect &rect);
@@ -3812,12 +4146,16 @@ public:
   void setInteraction(const QCP::Interaction &interaction, bool enabled=true);
   void setSelectionTolerance(int pixels);
   void setNoAntialiasingOnDrag(bool enabled);
+  void setProgressiveRefineDelay(int msec);
   void setPlottingHints(const QCP::PlottingHints &hints);
   void setPlottingHint(QCP::PlottingHint hint, bool enabled=true);
   void setMultiSelectModifier(Qt::KeyboardModifier modifier);
   void setSelectionRectMode(QCP::SelectionRectMode mode);
   void setSelectionRect(QCPSelectionRect *selectionRect);
   void setOpenGl(bool enabled, int multisampling=16);
+  void setParallelRasterization(bool enabled, int threadCount=0);
+  void setAsyncRendering(bool enabled);
+  void setProfilingEnabled(bool enabled);
   
   // non-property methods:
   // plottable interface:
@@ -3885,9 +4223,12 @@ public:
   bool saveBmp(const QString &fileName, int width=0, int height=0, double scale=1.0, int resolution=96, QCP::ResolutionUnit resolutionUnit=QCP::ruDotsPerInch);
   bool saveRastered(const QString &fileName, int width, int height, double scale, const char *format, int quality=-1, int resolution=96, QCP::ResolutionUnit resolutionUnit=QCP::ruDotsPerInch);
   QPixmap toPixmap(int width=0, int height=0, double scale=1.0);
+  QImage toImage(int width=0, int height=0, double scale=1.0);
   void toPainter(QCPPainter *painter, int width=0, int height=0);
   Q_SLOT void replot(QCustomPlot::RefreshPriority refreshPriority=QCustomPlot::rpRefreshHint);
   double replotTime(bool average=false) const;
+  void invalidateStaticLayers();
+  void invalidateLayout();
   
   QCPAxis *xAxis, *yAxis, *xAxis2, *yAxis2;
   QCPLegend *legend;
@@ -3927,9 +4268,10 @@ protected:
   QCP::Interactions mInteractions;
   int mSelectionTolerance;
   bool mNoAntialiasingOnDrag;
+  int mProgressiveRefineDelay;
   QBrush mBackgroundBrush;
   QPixmap mBackgroundPixmap;
-  QPixmap mScaledBackgroundPixmap;
+  QImage mBackgroundImage, mScaledBackgroundImage;
   bool mBackgroundScaled;
   Qt::AspectRatioMode mBackgroundScaledMode;
   QCPLayer *mCurrentLayer;
@@ -3938,6 +4280,7 @@ protected:
   QCP::SelectionRectMode mSelectionRectMode;
   QCPSelectionRect *mSelectionRect;
   bool mOpenGl;
+  bool mParallelRasterization;
   
   // non-property members:
   QList<QSharedPointer<QCPAbstractPaintBuffer> > mPaintBuffers;
@@ -3950,6 +4293,20 @@ protected:
   bool mReplotting;
   bool mReplotQueued;
   double mReplotTime, mReplotTimeAverage;
+  bool mStaticLayersValid;
+  QVector<double> mStaticLayerState;
+  bool mLayoutValid;
+  QVector<double> mLayoutState;
+  QThreadPool *mRasterThreadPool;
+  QCache<QByteArray, QPixmap> mScatterSpriteCache;
+  QCPRenderThread *mRenderThread;
+  QCPProfiler *mProfiler;
+  QTimer *mCoarseReplotTimer, *mRefineReplotTimer;
+  bool mCoarseReplot;
+  QPointer<QCPAxisRect> mInteractionAxisRect;
+  QPixmap mInteractionSnapshot;
+  QList<QPointer<QCPAxis> > mRenderedAxes;
+  QVector<QCPRange> mRenderedRanges;
   int mOpenGlMultisamples;
   QCP::AntialiasedElements mOpenGlAntialiasedElementsBackup;
   bool mOpenGlCacheLabelsBackup;
@@ -3980,6 +4337,8 @@ protected:
   Q_SLOT virtual void processPointSelection(QMouseEvent *event);
   
   // non-virtual methods:
+  Q_SLOT void coarseReplot();
+  Q_SLOT void refineReplot();
   bool registerPlottable(QCPAbstractPlottable *plottable);
   bool registerGraph(QCPGraph *graph);
   bool registerItem(QCPAbstractItem* item);
@@ -3990,6 +4349,15 @@ protected:
   void setupPaintBuffers();
   QCPAbstractPaintBuffer *createPaintBuffer();
   bool hasInvalidatedPaintBuffers();
+  QVector<double> staticLayerState() const;
+  QVector<double> layoutState();
+  void drawPaintBuffersParallel(const QList<QCPAbstractPaintBuffer*> &buffers);
+  QList<QCPGraph*> prepareGraphGeometry(const QList<QCPLayer*> &layers);
+  void discardGraphGeometry(const QList<QCPGraph*> &graphs);
+  void interactionReplot(QCPAxisRect *axisRect, QCustomPlot::RefreshPriority refreshPriority);
+  void recordRenderedRanges();
+  QPixmap axisRectSnapshot(QCPAxisRect *axisRect);
+  void drawInteractionSnapshot(QCPPainter *painter);
   bool setupOpenGl();
   void freeOpenGl();
   
@@ -4000,6 +4368,7 @@ protected:
   friend class QCPAbstractPlottable;
   friend class QCPGraph;
   friend class QCPAbstractItem;
+  friend class QCPRenderThread;
 };
 Q_DECLARE_METATYPE(QCustomPlot::LayerInsertMode)
 Q_DECLARE_METATYPE(QCustomPlot::RefreshPriority)
@@ -4102,6 +4471,41 @@ ItemType *QCustomPlot::itemAt(const QPointF &pos, bool onlySelectable) const
 /* end of 'src/core.h' */
 
 
+/* including file 'src/pointindex.h'       */
+
+class QCP_LIB_DECL QCPPointIndex
+{
+public:
+  QCPPointIndex();
+  
+  // getters:
+  bool isEmpty() const { return mPointCount == 0; }
+  QRectF bounds() const { return mBounds; }
+  
+  // non-virtual methods:
+  void clear();
+  void build(const QVector<QPointF> &points, bool indexSegments);
+  void findPoints(const QRectF &rect, QVector<int> &points) const;
+  void findSegments(const QRectF &rect, QVector<int> &segments) const;
+  
+protected:
+  // non-property members:
+  QRectF mBounds;
+  int mPointCount;
+  int mColumns, mRows;
+  double mCellWidth, mCellHeight;
+  QVector<int> mPointCellStart, mPointEntries;
+  QVector<int> mSegmentCellStart, mSegmentEntries, mLongSegments;
+  
+  // non-virtual methods:
+  int column(double x) const;
+  int row(double y) const;
+  bool cellRange(const QRectF &rect, int &columnBegin, int &columnEnd, int &rowBegin, int &rowEnd) const;
+};
+
+/* end of 'src/pointindex.h' */
+
+
 /* including file 'src/plottable1d.h'       */
 /* modified 2021-03-29T02:30:44, size 25638 */
 
@@ -4151,9 +4555,18 @@ protected:
   // property members:
   QSharedPointer<QCPDataContainer<DataType> > mDataContainer;
   
+  // non-property members:
+  mutable QCPPointIndex mPointIndex;
+  mutable quint64 mPointIndexRevision;
+  mutable int mPointIndexConfig;
+  
   // helpers for subclasses:
   void getDataSegments(QList<QCPDataRange> &selectedSegments, QList<QCPDataRange> &unselectedSegments) const;
   void drawPolyline(QCPPainter *painter, const QVector<QPointF> &lineData) const;
+  const QCPPointIndex &pointIndex(bool indexSegments) const;
+  QPointF pointIndexCoords(double key, double value) const;
+  QRectF pointIndexRect(const QRectF &pixelRect) const;
+  double indexedPointDistance(const QPointF &pixelPoint, typename QCPDataContainer<DataType>::const_iterator &closestData, bool includeSegments) const;
 
 private:
   Q_DISABLE_COPY(QCPAbstractPlottable1D)
@@ -4351,7 +4764,9 @@ private:
 template <class DataType>
 QCPAbstractPlottable1D<DataType>::QCPAbstractPlottable1D(QCPAxis *keyAxis, QCPAxis *valueAxis) :
   QCPAbstractPlottable(keyAxis, valueAxis),
-  mDataContainer(new QCPDataContainer<DataType>)
+  mDataContainer(new QCPDataContainer<DataType>),
+  mPointIndexRevision(0),
+  mPointIndexConfig(-1)
 {
 }
 
@@ -4630,7 +5045,9 @@ void QCPAbstractPlottable1D<DataType>::getDataSegments(QList<QCPDataRange> &sele
 
   Further it uses a faster line drawing technique based on \ref QCPPainter::drawLine rather than \c
   QPainter::drawPolyline if the configured \ref QCustomPlot::setPlottingHints() and \a painter
-  style allows.
+  style allows. With the hint \ref QCP::phRasterizeLines, thin solid cosmetic lines are written
+  directly into the paint buffer image by a \ref QCPLineRasterizer, whenever its requirements on the
+  painter state are met.
 */
 template <class DataType>
 void QCPAbstractPlottable1D<DataType>::drawPolyline(QCPPainter *painter, const QVector<QPointF> &lineData) const
@@ -4647,6 +5064,29 @@ void QCPAbstractPlottable1D<DataType>::drawPolyline(QCPPainter *painter, const Q
     painter->setPen(newPen);
   }
 
+  // if drawing thin solid line onto an image, bypass QPainter and rasterize directly:
+  if (mParentPlot->plottingHints().testFlag(QCP::phRasterizeLines) &&
+      !painter->modes().testFlag(QCPPainter::pmVectorized))
+  {
+    QCPLineRasterizer rasterizer(painter);
+    if (rasterizer.isValid())
+    {
+      int segmentStart = 0;
+      const int lineDataSize = lineData.size();
+      for (int i=0; i<lineDataSize; ++i)
+      {
+        if (!qIsFinite(lineData.at(i).x()) || !qIsFinite(lineData.at(i).y())) // NaNs create a gap in the line, rasterizer also requires finite coordinates
+        {
+          rasterizer.drawPolyline(lineData.constData()+segmentStart, i-segmentStart);
+          segmentStart = i+1;
+        }
+      }
+      // draw last segment:
+      rasterizer.drawPolyline(lineData.constData()+segmentStart, lineDataSize-segmentStart);
+      return;
+    }
+  }
+
   // if drawing solid line and not in PDF, use much faster line drawing instead of polyline:
   if (mParentPlot->plottingHints().testFlag(QCP::phFastPolylines) &&
       painter->pen().style() == Qt::SolidLine &&
@@ -4690,6 +5130,157 @@ void QCPAbstractPlottable1D<DataType>::drawPolyline(QCPPainter *painter, const Q
   }
 }
 
+/*!
+  Returns the spatial index of the data points (see \ref QCPPointIndex), which allows subclasses to
+  find the data points close to a pixel position without iterating over all data, e.g. in their
+  \ref selectTest implementation. If \a indexSegments is true, the line segments between
+  consecutive data points are indexed, too.
+
+  The index is built lazily upon the first call, and only rebuilt when the data changes (see \ref
+  QCPDataContainer::revision) or the scale type or sign domain of an axis changes. It is
+  independent of the axis ranges and the axis rect size, because it is built in (possibly
+  logarithmic) coordinates and not in pixels, so panning and zooming don't invalidate it.
+
+  \see pointIndexRect, indexedPointDistance
+*/
+template <class DataType>
+const QCPPointIndex &QCPAbstractPlottable1D<DataType>::pointIndex(bool indexSegments) const
+{
+  QCPAxis *keyAxis = mKeyAxis.data();
+  QCPAxis *valueAxis = mValueAxis.data();
+  int config = indexSegments ? 1 : 0;
+  if (keyAxis && keyAxis->scaleType() == QCPAxis::stLogarithmic)
+    config |= keyAxis->range().lower < 0 ? 0x04 : 0x02;
+  if (valueAxis && valueAxis->scaleType() == QCPAxis::stLogarithmic)
+    config |= valueAxis->range().lower < 0 ? 0x10 : 0x08;
+  
+  if (mPointIndexRevision != mDataContainer->revision() || mPointIndexConfig != config)
+  {
+    QVector<QPointF> points;
+    points.reserve(mDataContainer->size());
+    typename QCPDataContainer<DataType>::const_iterator end = mDataContainer->constEnd();
+    for (typename QCPDataContainer<DataType>::const_iterator it=mDataContainer->constBegin(); it!=end; ++it)
+      points.append(pointIndexCoords(it->mainKey(), it->mainValue()));
+    mPointIndex.build(points, indexSegments);
+    mPointIndexRevision = mDataContainer->revision();
+    mPointIndexConfig = config;
+  }
+  return mPointIndex;
+}
+
+/*!
+  Returns the coordinates used by the point index (\ref pointIndex) for the data point at \a key
+  and \a value. For linear axes, these are the plot coordinates. For logarithmic axes, the logarithm
+  of the coordinate is used, so straight lines in pixel space are straight lines in index space, too.
+  Coordinates that can't be displayed on a logarithmic axis (sign opposite to the axis range) are
+  NaN and thus not indexed.
+*/
+template <class DataType>
+QPointF QCPAbstractPlottable1D<DataType>::pointIndexCoords(double key, double value) const
+{
+  double coords[2] = {key, value};
+  QCPAxis *axes[2] = {mKeyAxis.data(), mValueAxis.data()};
+  for (int i=0; i<2; ++i)
+  {
+    if (axes[i] && axes[i]->scaleType() == QCPAxis::stLogarithmic)
+    {
+      if (axes[i]->range().lower < 0)
+        coords[i] = coords[i] < 0 ? qLn(-coords[i]) : qQNaN();
+      else
+        coords[i] = coords[i] > 0 ? qLn(coords[i]) : qQNaN();
+    }
+  }
+  return QPointF(coords[0], coords[1]);
+}
+
+/*!
+  Transforms the rect \a pixelRect, given in pixels, to the coordinates of the point index (see
+  \ref pointIndexCoords).
+*/
+template <class DataType>
+QRectF QCPAbstractPlottable1D<DataType>::pointIndexRect(const QRectF &pixelRect) const
+{
+  double key1, value1, key2, value2;
+  pixelsToCoords(pixelRect.topLeft(), key1, value1);
+  pixelsToCoords(pixelRect.bottomRight(), key2, value2);
+  return QRectF(pointIndexCoords(key1, value1), pointIndexCoords(key2, value2)).normalized();
+}
+
+/*!
+  Returns the pixel distance of \a pixelPoint to the closest data point, using the point index
+  (\ref pointIndex). The closest data point is returned in \a closestData. If \a includeSegments
+  is true, the distance to the straight lines between consecutive data points is taken into account
+  as well, so the returned distance may be smaller than the distance to \a closestData.
+
+  The search starts with the selection tolerance around \a pixelPoint and widens until a data point
+  is found, so its cost only depends on the number of data points near \a pixelPoint. Returns -1 if
+  there are no data points which can be displayed.
+*/
+template <class DataType>
+double QCPAbstractPlottable1D<DataType>::indexedPointDistance(const QPointF &pixelPoint, typename QCPDataContainer<DataType>::const_iterator &closestData, bool includeSegments) const
+{
+  closestData = mDataContainer->constEnd();
+  const QCPPointIndex &index = pointIndex(includeSegments);
+  if (index.isEmpty())
+    return -1.0;
+  
+  QVector<int> candidates;
+  double minDistSqr = (std::numeric_limits<double>::max)();
+  double radius = qMax(1.0, mParentPlot->selectionTolerance());
+  bool finalSearch = false;
+  forever
+  {
+    const QRectF searchRect = pointIndexRect(QRectF(pixelPoint.x()-radius, pixelPoint.y()-radius, 2*radius, 2*radius));
+    candidates.clear();
+    index.findPoints(searchRect, candidates);
+    for (int i=0; i<candidates.size(); ++i)
+    {
+      typename QCPDataContainer<DataType>::const_iterator it = mDataContainer->constBegin()+candidates.at(i);
+      const double currentDistSqr = QCPVector2D(coordsToPixels(it->mainKey(), it->mainValue())-pixelPoint).lengthSquared();
+      if (currentDistSqr < minDistSqr)
+      {
+        minDistSqr = currentDistSqr;
+        closestData = it;
+      }
+    }
+    if (finalSearch)
+      break;
+    if (closestData != mDataContainer->constEnd())
+    {
+      // the closest point so far may lie in a corner of the search square, so points outside the square might be closer. Search once more with its distance as radius:
+      const double closestDist = qSqrt(minDistSqr);
+      if (closestDist <= radius)
+        break;
+      radius = closestDist;
+      finalSearch = true;
+    } else
+    {
+      const QRectF bounds = index.bounds();
+      const bool coversIndex = searchRect.left() <= bounds.left() && searchRect.right() >= bounds.right() && searchRect.top() <= bounds.top() && searchRect.bottom() >= bounds.bottom();
+      if (coversIndex || radius > 1e7) // no displayable data points left to find
+        return -1.0;
+      radius *= 4;
+    }
+  }
+  
+  // distance to line segments can only be smaller than distance to closest point for segments inside the search square:
+  if (includeSegments)
+  {
+    const double radius = qSqrt(minDistSqr);
+    QVector<int> segments;
+    index.findSegments(pointIndexRect(QRectF(pixelPoint.x()-radius, pixelPoint.y()-radius, 2*radius, 2*radius)), segments);
+    QCPVector2D p(pixelPoint);
+    for (int i=0; i<segments.size(); ++i)
+    {
+      typename QCPDataContainer<DataType>::const_iterator it = mDataContainer->constBegin()+segments.at(i);
+      const double currentDistSqr = p.distanceSquaredToLine(coordsToPixels(it->mainKey(), it->mainValue()), coordsToPixels((it+1)->mainKey(), (it+1)->mainValue()));
+      if (currentDistSqr < minDistSqr)
+        minDistSqr = currentDistSqr;
+    }
+  }
+  return qSqrt(minDistSqr);
+}
+
 
 /* end of 'src/plottable1d.h' */
 
@@ -4789,6 +5380,10 @@ protected:
   // non-virtual methods:
   bool stopsUseAlpha() const;
   void updateColorBuffer();
+  void colorIndices(const double *data, const QCPRange &range, int *indices, int n, int dataIndexFactor, bool logarithmic) const;
+  QRgb nanRgb() const;
+  
+  friend class QCPColorMap;
 };
 Q_DECLARE_METATYPE(QCPColorGradient::ColorInterpolation)
 Q_DECLARE_METATYPE(QCPColorGradient::NanHandling)
@@ -4952,7 +5547,7 @@ protected:
   // property members:
   QBrush mBackgroundBrush;
   QPixmap mBackgroundPixmap;
-  QPixmap mScaledBackgroundPixmap;
+  QImage mBackgroundImage, mScaledBackgroundImage;
   bool mBackgroundScaled;
   Qt::AspectRatioMode mBackgroundScaledMode;
   QCPLayoutInset *mInsetLayout;
@@ -5423,7 +6018,8 @@ public:
   
   inline QCPRange valueRange() const { return QCPRange(value, value); }
   
-  double key, value;
+  QCPDataKey key;
+  QCPDataValue value;
 };
 Q_DECLARE_TYPEINFO(QCPGraphData, Q_PRIMITIVE_TYPE);
 
@@ -5502,6 +6098,16 @@ protected:
   QPointer<QCPGraph> mChannelFillGraph;
   bool mAdaptiveSampling;
   
+  // non-property members:
+  bool mGeometryPrepared;
+  int mPreparedUnselectedCount;
+  QList<QCPDataRange> mPreparedSegments;
+  QVector<QVector<QPointF> > mPreparedLines, mPreparedScatters;
+  mutable QVector<double> mChannelFillSignature;
+  mutable QVector<QPointF> mChannelFillOtherLines, mChannelFillLines;
+  mutable QVector<QCPDataRange> mChannelFillOtherSegments;
+  mutable QVector<QPolygonF> mChannelFillPolygons;
+  
   // reimplemented virtual methods:
   virtual void draw(QCPPainter *painter) Q_DECL_OVERRIDE;
   virtual void drawLegendIcon(QCPPainter *painter, const QRectF &rect) const Q_DECL_OVERRIDE;
@@ -5519,6 +6125,8 @@ protected:
   void getVisibleDataBounds(QCPGraphDataContainer::const_iterator &begin, QCPGraphDataContainer::const_iterator &end, const QCPDataRange &rangeRestriction) const;
   void getLines(QVector<QPointF> *lines, const QCPDataRange &dataRange) const;
   void getScatters(QVector<QPointF> *scatters, const QCPDataRange &dataRange) const;
+  void removeCoincidentScatters(QVector<QPointF> *scatters) const;
+  void dataToPixels(const QVector<QCPGraphData> &data, QVector<double> *keyPixels, QVector<double> *valuePixels) const;
   QVector<QPointF> dataToLines(const QVector<QCPGraphData> &data) const;
   QVector<QPointF> dataToStepLeftLines(const QVector<QCPGraphData> &data) const;
   QVector<QPointF> dataToStepRightLines(const QVector<QCPGraphData> &data) const;
@@ -5530,17 +6138,36 @@ protected:
   QPointF getFillBasePoint(QPointF matchingDataPoint) const;
   const QPolygonF getFillPolygon(const QVector<QPointF> *lineData, QCPDataRange segment) const;
   const QPolygonF getChannelFillPolygon(const QVector<QPointF> *thisData, QCPDataRange thisSegment, const QVector<QPointF> *otherData, QCPDataRange otherSegment) const;
+  void appendChannelFillPoints(QPolygonF &polygon, const QVector<QPointF> *data, QCPDataRange segment, double lower, double upper, bool reversed) const;
+  QVector<double> getChannelFillSignature() const;
   int findIndexBelowX(const QVector<QPointF> *data, double x) const;
   int findIndexAboveX(const QVector<QPointF> *data, double x) const;
   int findIndexBelowY(const QVector<QPointF> *data, double y) const;
   int findIndexAboveY(const QVector<QPointF> *data, double y) const;
   double pointDistance(const QPointF &pixelPoint, QCPGraphDataContainer::const_iterator &closestData) const;
+  void prepareGeometry();
+  void discardGeometry();
   
   friend class QCustomPlot;
   friend class QCPLegend;
+  friend class QCPGraphGeometryJob;
 };
 Q_DECLARE_METATYPE(QCPGraph::LineStyle)
 
+
+class QCPGraphGeometryJob : public QRunnable
+{
+public:
+  explicit QCPGraphGeometryJob(QCPGraph *graph);
+  
+  // reimplemented virtual methods:
+  virtual void run() Q_DECL_OVERRIDE;
+  
+protected:
+  // non-property members:
+  QCPGraph *mGraph;
+};
+
 /* end of 'src/plottables/plottable-graph.h' */
 
 
@@ -5562,7 +6189,7 @@ public:
   
   inline QCPRange valueRange() const { return QCPRange(value, value); }
   
-  double t, key, value;
+  QCPDataValue t, key, value;
 };
 Q_DECLARE_TYPEINFO(QCPCurveData, Q_PRIMITIVE_TYPE);
 
@@ -5586,6 +6213,7 @@ class QCP_LIB_DECL QCPCurve : public QCPAbstractPlottable1D<QCPCurveData>
   Q_PROPERTY(QCPScatterStyle scatterStyle READ scatterStyle WRITE setScatterStyle)
   Q_PROPERTY(int scatterSkip READ scatterSkip WRITE setScatterSkip)
   Q_PROPERTY(LineStyle lineStyle READ lineStyle WRITE setLineStyle)
+  Q_PROPERTY(bool adaptiveSampling READ adaptiveSampling WRITE setAdaptiveSampling)
   /// \endcond
 public:
   /*!
@@ -5606,6 +6234,7 @@ public:
   QCPScatterStyle scatterStyle() const { return mScatterStyle; }
   int scatterSkip() const { return mScatterSkip; }
   LineStyle lineStyle() const { return mLineStyle; }
+  bool adaptiveSampling() const { return mAdaptiveSampling; }
   
   // setters:
   void setData(QSharedPointer<QCPCurveDataContainer> data);
@@ -5614,6 +6243,7 @@ public:
   void setScatterStyle(const QCPScatterStyle &style);
   void setScatterSkip(int skip);
   void setLineStyle(LineStyle style);
+  void setAdaptiveSampling(bool enabled);
   
   // non-property methods:
   void addData(const QVector<double> &t, const QVector<double> &keys, const QVector<double> &values, bool alreadySorted=false);
@@ -5631,6 +6261,7 @@ protected:
   QCPScatterStyle mScatterStyle;
   int mScatterSkip;
   LineStyle mLineStyle;
+  bool mAdaptiveSampling;
   
   // reimplemented virtual methods:
   virtual void draw(QCPPainter *painter) Q_DECL_OVERRIDE;
@@ -5659,6 +6290,155 @@ Q_DECLARE_METATYPE(QCPCurve::LineStyle)
 /* end of 'src/plottables/plottable-curve.h' */
 
 
+/* including file 'src/renderthread.h'      */
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+typedef QRecursiveMutex QCPRecursiveMutex;
+#else
+class QCPRecursiveMutex : public QMutex // no QCP_LIB_DECL, fully inline
+{
+public:
+  QCPRecursiveMutex() : QMutex(QMutex::Recursive) {}
+};
+#endif
+
+class QCP_LIB_DECL QCPRenderThread : public QThread
+{
+  Q_OBJECT
+public:
+  explicit QCPRenderThread(QCustomPlot *parentPlot);
+  virtual ~QCPRenderThread() Q_DECL_OVERRIDE;
+  
+  // getters:
+  QCustomPlot *parentPlot() const { return mParentPlot; }
+  QCPRecursiveMutex *plotMutex() { return &mPlotMutex; }
+  double frameTime() const;
+  
+  // non-virtual methods:
+  void submitData(QCPGraph *graph, const QSharedPointer<QCPGraphDataContainer> &data);
+  void submitData(QCPCurve *curve, const QSharedPointer<QCPCurveDataContainer> &data);
+  void requestFrame();
+  void stop();
+  bool drawFrame(QPainter *painter);
+  
+signals:
+  void frameReady();
+  
+protected:
+  // non-property members:
+  QCustomPlot *mParentPlot;
+  QCPRecursiveMutex mPlotMutex;
+  mutable QMutex mRequestMutex;
+  QWaitCondition mRequestCondition;
+  bool mFrameRequested;
+  bool mStopRequested;
+  double mFrameTime;
+  QList<QPair<QPointer<QCPGraph>, QSharedPointer<QCPGraphDataContainer> > > mPendingGraphData;
+  QList<QPair<QPointer<QCPCurve>, QSharedPointer<QCPCurveDataContainer> > > mPendingCurveData;
+  QMutex mFrameMutex;
+  QImage mFrontFrame, mBackFrame;
+  
+  // reimplemented virtual methods:
+  virtual void run() Q_DECL_OVERRIDE;
+  
+  // non-virtual methods:
+  void applySnapshots();
+  void renderFrame();
+  
+private:
+  Q_DISABLE_COPY(QCPRenderThread)
+};
+
+/* end of 'src/renderthread.h' */
+
+
+/* including file 'src/batchrenderer.h'     */
+
+class QCP_LIB_DECL QCPBatchRenderer : public QObject
+{
+  Q_OBJECT
+public:
+  /*!
+    Configures the plot of a job before it is exported, e.g. by adding plottables, setting their
+    data and adjusting the axes. Called in the thread that runs \ref QCPBatchRenderer::run.
+  */
+  typedef std::function<void(QCustomPlot *plot)> SetupFunction;
+  
+  explicit QCPBatchRenderer(QObject *parent=nullptr);
+  virtual ~QCPBatchRenderer() Q_DECL_OVERRIDE;
+  
+  // getters:
+  int threadCount() const { return mThreadCount; }
+  QCP::ExportPen exportPen() const { return mExportPen; }
+  int pendingJobCount() const { return mJobs.size(); }
+  int renderedCount() const { return mRenderedCount; }
+  int failedCount() const { return mFailedCount; }
+  double elapsedTime() const { return mElapsedTime; }
+  double chartsPerSecond() const;
+  double chartsPerSecondPerCore() const;
+  
+  // setters:
+  void setThreadCount(int count);
+  void setExportPen(QCP::ExportPen exportPen);
+  
+  // non-virtual methods:
+  void addJob(const QString &fileName, int width, int height, const SetupFunction &setup, double scale=1.0);
+  void clearJobs();
+  int run();
+  
+signals:
+  void jobFinished(const QString &fileName, bool success);
+  
+protected:
+  struct Job
+  {
+    QString fileName;
+    int width, height;
+    double scale;
+    SetupFunction setup;
+  };
+  
+  // property members:
+  int mThreadCount;
+  QCP::ExportPen mExportPen;
+  // non-property members:
+  QList<Job> mJobs;
+  int mRenderedCount, mFailedCount;
+  double mElapsedTime;
+  QMutex mFinishedMutex;
+  QWaitCondition mFinishedCondition;
+  QList<QPair<QCustomPlot*, bool> > mFinishedPlots;
+  
+  // non-virtual methods:
+  void reportFinished(QCustomPlot *plot, bool success);
+  
+private:
+  Q_DISABLE_COPY(QCPBatchRenderer)
+  
+  friend class QCPBatchRenderTask;
+};
+
+class QCPBatchRenderTask : public QRunnable
+{
+public:
+  QCPBatchRenderTask(QCPBatchRenderer *renderer, QCustomPlot *plot, const QString &fileName, int width, int height, double scale, QCP::ExportPen exportPen);
+  
+  // reimplemented virtual methods:
+  virtual void run() Q_DECL_OVERRIDE;
+  
+protected:
+  // non-property members:
+  QCPBatchRenderer *mRenderer;
+  QCustomPlot *mPlot;
+  QString mFileName;
+  int mWidth, mHeight;
+  double mScale;
+  QCP::ExportPen mExportPen;
+};
+
+/* end of 'src/batchrenderer.h' */
+
+
 /* including file 'src/plottables/plottable-bars.h' */
 /* modified 2021-03-29T02:30:44, size 8955          */
 
@@ -5767,6 +6547,7 @@ class QCP_LIB_DECL QCPBars : public QCPAbstractPlottable1D<QCPBarsData>
   Q_PROPERTY(QCPBarsGroup* barsGroup READ barsGroup WRITE setBarsGroup)
   Q_PROPERTY(double baseValue READ baseValue WRITE setBaseValue)
   Q_PROPERTY(double stackingGap READ stackingGap WRITE setStackingGap)
+  Q_PROPERTY(bool denseMerging READ denseMerging WRITE setDenseMerging)
   Q_PROPERTY(QCPBars* barBelow READ barBelow)
   Q_PROPERTY(QCPBars* barAbove READ barAbove)
   /// \endcond
@@ -5792,6 +6573,7 @@ public:
   QCPBarsGroup *barsGroup() const { return mBarsGroup; }
   double baseValue() const { return mBaseValue; }
   double stackingGap() const { return mStackingGap; }
+  bool denseMerging() const { return mDenseMerging; }
   QCPBars *barBelow() const { return mBarBelow.data(); }
   QCPBars *barAbove() const { return mBarAbove.data(); }
   QSharedPointer<QCPBarsDataContainer> data() const { return mDataContainer; }
@@ -5804,6 +6586,7 @@ public:
   void setBarsGroup(QCPBarsGroup *barsGroup);
   void setBaseValue(double baseValue);
   void setStackingGap(double pixels);
+  void setDenseMerging(bool enabled);
   
   // non-property methods:
   void addData(const QVector<double> &keys, const QVector<double> &values, bool alreadySorted=false);
@@ -5825,6 +6608,7 @@ protected:
   QCPBarsGroup *mBarsGroup;
   double mBaseValue;
   double mStackingGap;
+  bool mDenseMerging;
   QPointer<QCPBars> mBarBelow, mBarAbove;
   
   // reimplemented virtual methods:
@@ -5961,6 +6745,104 @@ protected:
   friend class QCPLegend;
 };
 
+
+class QCP_LIB_DECL QCPQuantileSketch
+{
+public:
+  explicit QCPQuantileSketch(double compression=100);
+  
+  // getters:
+  double compression() const { return mCompression; }
+  double count() const { return mTotalWeight; }
+  double minimum() const { return mMinimum; }
+  double maximum() const { return mMaximum; }
+  bool isEmpty() const { return mTotalWeight <= 0; }
+  
+  // setters:
+  void setCompression(double compression);
+  
+  // non-property methods:
+  void add(double value, double weight=1);
+  double quantile(double q) const;
+  int centroidCount() const;
+  void clear();
+  
+protected:
+  struct Centroid
+  {
+    double mean, weight;
+  };
+  
+  // property members:
+  double mCompression;
+  
+  // non-property members:
+  mutable QVector<Centroid> mCentroids;
+  mutable QVector<Centroid> mBuffer;
+  double mTotalWeight, mMinimum, mMaximum;
+  
+  // non-virtual methods:
+  void compress() const;
+  double quantileLimit(double q) const;
+};
+
+
+class QCP_LIB_DECL QCPStatisticalBoxAggregator
+{
+public:
+  QCPStatisticalBoxAggregator(const QSharedPointer<QCPStatisticalBoxDataContainer> &container, double bucketSize, double bucketOffset=0);
+  
+  // getters:
+  QSharedPointer<QCPStatisticalBoxDataContainer> container() const { return mContainer; }
+  double bucketSize() const { return mBucketSize; }
+  double bucketOffset() const { return mBucketOffset; }
+  double compression() const { return mCompression; }
+  QCPRange outlierThreshold() const { return mOutlierThreshold; }
+  int maximumOutliers() const { return mMaximumOutliers; }
+  int openBucketCount() const { return mOpenBucketCount; }
+  
+  // setters:
+  void setContainer(const QSharedPointer<QCPStatisticalBoxDataContainer> &container);
+  void setBucket(double bucketSize, double bucketOffset=0);
+  void setCompression(double compression);
+  void setOutlierThreshold(const QCPRange &threshold);
+  void setMaximumOutliers(int count);
+  void setOpenBucketCount(int count);
+  
+  // non-property methods:
+  bool addSample(double time, double value);
+  void addSamples(const QVector<double> &time, const QVector<double> &value);
+  void updateData();
+  double bucketKey(double time) const;
+  void clear();
+  
+protected:
+  struct Bucket
+  {
+    QCPQuantileSketch sketch;
+    double minimum, maximum; // of the samples within the outlier threshold
+    QVector<double> outliers;
+    bool modified; // has samples that aren't reflected in the container yet
+  };
+  
+  // property members:
+  QSharedPointer<QCPStatisticalBoxDataContainer> mContainer;
+  double mBucketSize, mBucketOffset;
+  double mCompression;
+  QCPRange mOutlierThreshold;
+  int mMaximumOutliers;
+  int mOpenBucketCount;
+  
+  // non-property members:
+  QMap<double, Bucket> mBuckets;
+  
+  // non-virtual methods:
+  Bucket *bucketForSample(double key);
+  void addToBucket(Bucket *bucket, double value);
+  void updateBoxData(double key, Bucket &bucket);
+  void closeOldestBucket();
+};
+
 /* end of 'src/plottables/plottable-statisticalbox.h' */
 
 
@@ -5997,6 +6879,7 @@ public:
   void setAlpha(int keyIndex, int valueIndex, unsigned char alpha);
   
   // non-property methods:
+  void appendKeyColumn(const QVector<double> &values);
   void recalculateDataBounds();
   void clear();
   void clearAlpha();
@@ -6017,8 +6900,11 @@ protected:
   unsigned char *mAlpha;
   QCPRange mDataBounds;
   bool mDataModified;
+  int mKeyOffset; // storage column of key index 0, the key columns form a ring (see appendKeyColumn)
+  int mAppendedColumns; // key columns appended since the color map last updated its map image
   
   bool createAlpha(bool initializeOpaque=true);
+  int storageKeyIndex(int keyIndex) const { const int i = keyIndex+mKeyOffset; return i < mKeySize ? i : i-mKeySize; }
   
   friend class QCPColorMap;
 };
@@ -6047,6 +6933,7 @@ public:
   bool tightBoundary() const { return mTightBoundary; }
   QCPColorGradient gradient() const { return mGradient; }
   QCPColorScale *colorScale() const { return mColorScale.data(); }
+  int colorizeThreadCount() const { return mColorizeThreadCount; }
   
   // setters:
   void setData(QCPColorMapData *data, bool copy=false);
@@ -6056,6 +6943,7 @@ public:
   void setInterpolate(bool enabled);
   void setTightBoundary(bool enabled);
   void setColorScale(QCPColorScale *colorScale);
+  void setColorizeThreadCount(int threadCount);
   
   // non-property methods:
   void rescaleDataRange(bool recalculateDataBounds=false);
@@ -6080,11 +6968,13 @@ protected:
   bool mInterpolate;
   bool mTightBoundary;
   QPointer<QCPColorScale> mColorScale;
+  int mColorizeThreadCount;
   
   // non-property members:
   QImage mMapImage, mUndersampledMapImage;
   QPixmap mLegendIcon;
   bool mMapImageInvalidated;
+  QThreadPool *mColorizeThreadPool;
   
   // introduced virtual methods:
   virtual void updateMapImage();
@@ -6093,8 +6983,31 @@ protected:
   virtual void draw(QCPPainter *painter) Q_DECL_OVERRIDE;
   virtual void drawLegendIcon(QCPPainter *painter, const QRectF &rect) const Q_DECL_OVERRIDE;
   
+  // non-virtual methods:
+  void colorizeLines(uchar *bits, int bytesPerLine, int beginLine, int endLine);
+  void updateMapImageColumns();
+  void drawMapImage(QPainter *painter, const QRectF &targetRect, bool mirrorX, bool mirrorY) const;
+  
   friend class QCustomPlot;
   friend class QCPLegend;
+  friend class QCPColorizeJob;
+};
+
+
+class QCPColorizeJob : public QRunnable
+{
+public:
+  QCPColorizeJob(QCPColorMap *colorMap, uchar *bits, int bytesPerLine, int beginLine, int endLine);
+  
+  // reimplemented virtual methods:
+  virtual void run() Q_DECL_OVERRIDE;
+  
+protected:
+  // non-property members:
+  QCPColorMap *mColorMap;
+  uchar *mBits;
+  int mBytesPerLine;
+  int mBeginLine, mEndLine;
 };
 
 /* end of 'src/plottables/plottable-colormap.h' */
@@ -6236,6 +7149,32 @@ protected:
 };
 Q_DECLARE_METATYPE(QCPFinancial::ChartStyle)
 
+
+class QCP_LIB_DECL QCPOhlcAggregator
+{
+public:
+  QCPOhlcAggregator(const QSharedPointer<QCPFinancialDataContainer> &container, double timeBinSize, double timeBinOffset=0);
+  
+  // getters:
+  QSharedPointer<QCPFinancialDataContainer> container() const { return mContainer; }
+  double timeBinSize() const { return mTimeBinSize; }
+  double timeBinOffset() const { return mTimeBinOffset; }
+  
+  // setters:
+  void setContainer(const QSharedPointer<QCPFinancialDataContainer> &container);
+  void setTimeBin(double timeBinSize, double timeBinOffset=0);
+  
+  // non-property methods:
+  void addSample(double time, double value);
+  void addSamples(const QVector<double> &time, const QVector<double> &value);
+  double binKey(double time) const;
+  
+protected:
+  // property members:
+  QSharedPointer<QCPFinancialDataContainer> mContainer;
+  double mTimeBinSize, mTimeBinOffset;
+};
+
 /* end of 'src/plottables/plottable-financial.h' */
 
 
@@ -6350,6 +7289,7 @@ protected:
   
   // non-virtual methods:
   void getErrorBarLines(QCPErrorBarsDataContainer::const_iterator it, QVector<QLineF> &backbones, QVector<QLineF> &whiskers) const;
+  void cullErrorBarLines(QVector<QLineF> &backbones, QVector<QLineF> &whiskers) const;
   void getVisibleDataBounds(QCPErrorBarsDataContainer::const_iterator &begin, QCPErrorBarsDataContainer::const_iterator &end, const QCPDataRange &rangeRestriction) const;
   double pointDistance(const QPointF &pixelPoint, QCPErrorBarsDataContainer::const_iterator &closestData) const;
   // helpers:
@@ -6364,6 +7304,85 @@ protected:
 /* end of 'src/plottables/plottable-errorbar.h' */
 
 
+/* including file 'src/plottables/plottable-mappedgraph.h' */
+
+class QCP_LIB_DECL QCPMappedGraph : public QCPAbstractPlottable, public QCPPlottableInterface1D
+{
+  Q_OBJECT
+  /// \cond INCLUDE_QPROPERTIES
+  Q_PROPERTY(bool lineVisible READ lineVisible WRITE setLineVisible)
+  Q_PROPERTY(QCPScatterStyle scatterStyle READ scatterStyle WRITE setScatterStyle)
+  /// \endcond
+public:
+  explicit QCPMappedGraph(QCPAxis *keyAxis, QCPAxis *valueAxis);
+  virtual ~QCPMappedGraph() Q_DECL_OVERRIDE;
+  
+  // getters:
+  QString fileName() const { return mFile.fileName(); }
+  bool isOpen() const { return mKeys != nullptr; }
+  bool lineVisible() const { return mLineVisible; }
+  QCPScatterStyle scatterStyle() const { return mScatterStyle; }
+  
+  // setters:
+  void setLineVisible(bool visible);
+  void setScatterStyle(const QCPScatterStyle &style);
+  
+  // non-property methods:
+  bool open(const QString &fileName);
+  bool open(const QString &fileName, qint64 keyColumnOffset, qint64 valueColumnOffset, int count);
+  void close();
+  
+  // virtual methods of 1d plottable interface:
+  virtual int dataCount() const Q_DECL_OVERRIDE;
+  virtual double dataMainKey(int index) const Q_DECL_OVERRIDE;
+  virtual double dataSortKey(int index) const Q_DECL_OVERRIDE;
+  virtual double dataMainValue(int index) const Q_DECL_OVERRIDE;
+  virtual QCPRange dataValueRange(int index) const Q_DECL_OVERRIDE;
+  virtual QPointF dataPixelPosition(int index) const Q_DECL_OVERRIDE;
+  virtual bool sortKeyIsMainKey() const Q_DECL_OVERRIDE;
+  virtual QCPDataSelection selectTestRect(const QRectF &rect, bool onlySelectable) const Q_DECL_OVERRIDE;
+  virtual int findBegin(double sortKey, bool expandedRange=true) const Q_DECL_OVERRIDE;
+  virtual int findEnd(double sortKey, bool expandedRange=true) const Q_DECL_OVERRIDE;
+  
+  // reimplemented virtual methods:
+  virtual double selectTest(const QPointF &pos, bool onlySelectable, QVariant *details=nullptr) const Q_DECL_OVERRIDE;
+  virtual QCPPlottableInterface1D *interface1D() Q_DECL_OVERRIDE { return this; }
+  virtual QCPRange getKeyRange(bool &foundRange, QCP::SignDomain inSignDomain=QCP::sdBoth) const Q_DECL_OVERRIDE;
+  virtual QCPRange getValueRange(bool &foundRange, QCP::SignDomain inSignDomain=QCP::sdBoth, const QCPRange &inKeyRange=QCPRange()) const Q_DECL_OVERRIDE;
+  
+protected:
+  // property members:
+  bool mLineVisible;
+  QCPScatterStyle mScatterStyle;
+  
+  // non-property members:
+  QFile mFile;
+  uchar *mMap;
+  const double *mKeys, *mValues;
+  int mCount;
+  mutable QVector<QCPRange> mBlockValueRanges;
+  mutable QBitArray mBlockValueRangesValid;
+  
+  // reimplemented virtual methods:
+  virtual void draw(QCPPainter *painter) Q_DECL_OVERRIDE;
+  virtual void drawLegendIcon(QCPPainter *painter, const QRectF &rect) const Q_DECL_OVERRIDE;
+  
+  // non-virtual methods:
+  void getLines(QVector<QPointF> *lines, const QCPDataRange &dataRange) const;
+  void drawPolyline(QCPPainter *painter, const QVector<QPointF> &lineData) const;
+  QCPRange valueSpan(int begin, int end) const;
+  QCPRange scanValueSpan(int begin, int end) const;
+  double pointDistance(const QPointF &pixelPoint, int &closestIndex) const;
+  // helpers:
+  void getDataSegments(QList<QCPDataRange> &selectedSegments, QList<QCPDataRange> &unselectedSegments) const;
+  
+  friend class QCustomPlot;
+  friend class QCPLegend;
+};
+
+/* end of 'src/plottables/plottable-mappedgraph.h' */
+
+
 /* including file 'src/items/item-straightline.h' */
 /* modified 2021-03-29T02:30:44, size 3137        */
 
@@ -7383,7 +8402,7 @@ protected:
   // property members:
   QBrush mBackgroundBrush;
   QPixmap mBackgroundPixmap;
-  QPixmap mScaledBackgroundPixmap;
+  QImage mBackgroundImage, mScaledBackgroundImage;
   bool mBackgroundScaled;
   Qt::AspectRatioMode mBackgroundScaledMode;
   QCPLayoutInset *mInsetLayout;
@@ -0,0 +1,338 @@
+/***************************************************
+ Water Research Module
+ <https://github.com/TonyCooT/water_research_module>
+
+ ***************************************************
+ Accuracy tests and benchmarks for the rendering optimizations of the bundled QCustomPlot.
+
+ Apache License 2.0.
+ See <https://www.apache.org/licenses/> for details.
+ All above must be included in any redistribution.
+ ****************************************************/
+
+#include <QtTest>
+#include <random>
+#include "qcustomplot.h"
+
+namespace
+{
+
+/*
+  Returns a random polyline of pointCount points in an area of the given size. If walk is true, the
+  points advance evenly from left to right with a random walk in y, like the data of a dense graph.
+  Otherwise the points are spread over the whole area (and slightly beyond, to exercise clipping),
+  so the polyline consists of long segments in all directions.
+*/
+QVector<QPointF> randomPolyline(std::mt19937 &rng, const QSize &size, int pointCount, bool walk)
+{
+  QVector<QPointF> points(pointCount);
+  if (walk)
+  {
+    std::uniform_real_distribution<double> step(-4.0, 4.0);
+    double y = size.height()*0.5;
+    for (int i=0; i<pointCount; ++i)
+    {
+      y = qBound(0.0, y+step(rng), double(size.height()-1));
+      points[i] = QPointF(i*(size.width()-1.0)/(pointCount-1), y);
+    }
+  } else
+  {
+    std::uniform_real_distribution<double> x(-0.1*size.width(), 1.1*size.width());
+    std::uniform_real_distribution<double> y(-0.1*size.height(), 1.1*size.height());
+    for (int i=0; i<pointCount; ++i)
+      points[i] = QPointF(x(rng), y(rng));
+  }
+  return points;
+}
+
+/*
+  Draws points as a polyline with a cosmetic one pixel pen of the given color onto a transparent
+  image. If rasterize is true, the polyline is drawn with QCPLineRasterizer, otherwise with
+  QPainter. Returns a null image if the rasterizer doesn't accept the painter state.
+*/
+QImage renderPolyline(const QVector<QPointF> &points, const QSize &size, const QColor &color, bool antialiased, bool rasterize)
+{
+  QImage image(size, QImage::Format_ARGB32_Premultiplied);
+  image.fill(Qt::transparent);
+  QCPPainter painter(&image);
+  QPen pen(color, 1);
+  pen.setCosmetic(true);
+  painter.setPen(pen);
+  painter.setAntialiasing(antialiased);
+  if (rasterize)
+  {
+    QCPLineRasterizer rasterizer(&painter);
+    if (!rasterizer.isValid())
+      return QImage();
+    rasterizer.drawPolyline(points.constData(), points.size());
+  } else
+    painter.drawPolyline(points.constData(), points.size());
+  return image;
+}
+
+/*
+  Returns the sum of the alpha values of all pixels of image, in units of fully covered pixels.
+*/
+double totalCoverage(const QImage &image)
+{
+  double result = 0;
+  for (int y=0; y<image.height(); ++y)
+  {
+    const QRgb *line = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+    for (int x=0; x<image.width(); ++x)
+      result += qAlpha(line[x])/255.0;
+  }
+  return result;
+}
+
+/*
+  Returns the number of pixels of image with an alpha value of at least threshold, for which the
+  other image has no painted pixel within a distance of one pixel (including diagonals).
+*/
+int unmatchedPixels(const QImage &image, const QImage &other, int threshold)
+{
+  int result = 0;
+  for (int y=0; y<image.height(); ++y)
+  {
+    for (int x=0; x<image.width(); ++x)
+    {
+      if (qAlpha(image.pixel(x, y)) < threshold)
+        continue;
+      bool matched = false;
+      for (int oy=qMax(0, y-1); oy<=qMin(other.height()-1, y+1) && !matched; ++oy)
+      {
+        for (int ox=qMax(0, x-1); ox<=qMin(other.width()-1, x+1) && !matched; ++ox)
+          matched = qAlpha(other.pixel(ox, oy)) > 0;
+      }
+      if (!matched)
+        ++result;
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+class TestQCustomPlot : public QObject
+{
+  Q_OBJECT
+private slots:
+  void lineRasterizerMatchesQPainter_data();
+  void lineRasterizerMatchesQPainter();
+  void lineRasterizerThroughput_data();
+  void lineRasterizerThroughput();
+  void parallelRasterizationScaling_data();
+  void parallelRasterizationScaling();
+  void graphGeometryScaling_data();
+  void graphGeometryScaling();
+};
+
+void TestQCustomPlot::lineRasterizerMatchesQPainter_data()
+{
+  QTest::addColumn<bool>("antialiased");
+  QTest::addColumn<int>("alpha");
+  QTest::addColumn<bool>("walk");
+
+  // translucent polylines are only tested with few crossings, since QPainter and the rasterizer
+  // needn't agree on how often a pixel at a crossing is blended:
+  QTest::newRow("aliased, spread") << false << 255 << false;
+  QTest::newRow("aliased, random walk") << false << 255 << true;
+  QTest::newRow("aliased, translucent") << false << 128 << false;
+  QTest::newRow("antialiased, spread") << true << 255 << false;
+  QTest::newRow("antialiased, random walk") << true << 255 << true;
+  QTest::newRow("antialiased, translucent") << true << 128 << false;
+}
+
+/*
+  Draws random polylines with QPainter and with QCPLineRasterizer and compares the images. The two
+  don't place every pixel identically (Bresenham and Wu vs. Qt's cosmetic stroker), so the
+  tolerance is:
+  - the total coverage (sum of alpha) differs by at most 5% for aliased and 10% for antialiased
+    lines,
+  - every pixel painted by one of them (for antialiased lines: covered to at least 50%) lies within
+    one pixel of a pixel painted by the other.
+*/
+void TestQCustomPlot::lineRasterizerMatchesQPainter()
+{
+  QFETCH(bool, antialiased);
+  QFETCH(int, alpha);
+  QFETCH(bool, walk);
+
+  const QSize size(256, 256);
+  const QColor color(20, 60, 200, alpha);
+  const double coverageTolerance = antialiased ? 0.10 : 0.05;
+  const int threshold = antialiased ? 128*alpha/255 : 1;
+  std::mt19937 rng(29);
+  for (int run=0; run<20; ++run)
+  {
+    const QVector<QPointF> points = randomPolyline(rng, size, walk ? 2000 : 50, walk);
+    const QImage expected = renderPolyline(points, size, color, antialiased, false);
+    const QImage actual = renderPolyline(points, size, color, antialiased, true);
+    QVERIFY2(!actual.isNull(), "rasterizer rejected the painter state");
+
+    const double expectedCoverage = totalCoverage(expected);
+    const double actualCoverage = totalCoverage(actual);
+    QVERIFY2(qAbs(actualCoverage-expectedCoverage) <= coverageTolerance*expectedCoverage,
+             qPrintable(QString("run %1: coverage %2, QPainter %3").arg(run).arg(actualCoverage).arg(expectedCoverage)));
+    const int missing = unmatchedPixels(expected, actual, threshold);
+    const int extra = unmatchedPixels(actual, expected, threshold);
+    QVERIFY2(missing == 0 && extra == 0,
+             qPrintable(QString("run %1: %2 pixels missing, %3 extra").arg(run).arg(missing).arg(extra)));
+  }
+}
+
+void TestQCustomPlot::lineRasterizerThroughput_data()
+{
+  QTest::addColumn<bool>("rasterize");
+  QTest::addColumn<bool>("antialiased");
+
+  QTest::newRow("QPainter, aliased") << false << false;
+  QTest::newRow("rasterizer, aliased") << true << false;
+  QTest::newRow("QPainter, antialiased") << false << true;
+  QTest::newRow("rasterizer, antialiased") << true << true;
+}
+
+/*
+  Measures drawing a graph-like polyline of 100,000 points onto a 1000x600 image, with QPainter and
+  with QCPLineRasterizer.
+*/
+void TestQCustomPlot::lineRasterizerThroughput()
+{
+  QFETCH(bool, rasterize);
+  QFETCH(bool, antialiased);
+
+  QImage image(1000, 600, QImage::Format_ARGB32_Premultiplied);
+  image.fill(Qt::white);
+  std::mt19937 rng(29);
+  const QVector<QPointF> points = randomPolyline(rng, image.size(), 100000, true);
+  QCPPainter painter(&image);
+  QPen pen(Qt::blue, 1);
+  pen.setCosmetic(true);
+  painter.setPen(pen);
+  painter.setAntialiasing(antialiased);
+  if (rasterize)
+  {
+    QCPLineRasterizer rasterizer(&painter);
+    QVERIFY(rasterizer.isValid());
+    QBENCHMARK { rasterizer.drawPolyline(points.constData(), points.size()); }
+  } else
+  {
+    QBENCHMARK { painter.drawPolyline(points.constData(), points.size()); }
+  }
+}
+
+void TestQCustomPlot::parallelRasterizationScaling_data()
+{
+  QTest::addColumn<int>("threadCount");
+
+  QTest::newRow("serial") << 0;
+  QTest::newRow("1 thread") << 1;
+  QTest::newRow("2 threads") << 2;
+  QTest::newRow("4 threads") << 4;
+  QTest::newRow("8 threads") << 8;
+  QTest::newRow("16 threads") << 16;
+}
+
+/*
+  Measures full replots of a 1600x1200 plot with a 4x4 grid of axis rects, each showing a graph of
+  50,000 points (without adaptive sampling) on a buffered layer. Since the graphs are clipped to
+  disjoint axis rects, each of them is rasterized as a separate job. The rows compare serial
+  drawing with parallel rasterization on 1 to 16 threads.
+*/
+void TestQCustomPlot::parallelRasterizationScaling()
+{
+  QFETCH(int, threadCount);
+  if (threadCount > 0 && !QFontDatabase::supportsThreadedFontRendering())
+    QSKIP("platform doesn't support threaded font rendering");
+
+  QCustomPlot plot;
+  plot.resize(1600, 1200);
+  plot.plotLayout()->clear();
+  plot.addLayer("graphs");
+  plot.layer("graphs")->setMode(QCPLayer::lmBuffered);
+  std::mt19937 rng(27);
+  std::normal_distribution<double> noise(0.0, 1.0);
+  for (int row=0; row<4; ++row)
+  {
+    for (int column=0; column<4; ++column)
+    {
+      QCPAxisRect *axisRect = new QCPAxisRect(&plot);
+      plot.plotLayout()->addElement(row, column, axisRect);
+      QCPGraph *graph = plot.addGraph(axisRect->axis(QCPAxis::atBottom), axisRect->axis(QCPAxis::atLeft));
+      graph->setLayer("graphs");
+      graph->setAdaptiveSampling(false);
+      QVector<double> keys(50000), values(50000);
+      double value = 0;
+      for (int i=0; i<keys.size(); ++i)
+      {
+        value += noise(rng);
+        keys[i] = i;
+        values[i] = value;
+      }
+      graph->setData(keys, values, true);
+      graph->rescaleAxes();
+    }
+  }
+  plot.setParallelRasterization(threadCount > 0, threadCount);
+  QCOMPARE(plot.parallelRasterization(), threadCount > 0);
+  plot.replot(); // sets up the paint buffers
+  QBENCHMARK { plot.replot(); }
+}
+
+void TestQCustomPlot::graphGeometryScaling_data()
+{
+  QTest::addColumn<bool>("parallel");
+
+  QTest::newRow("serial") << false;
+  QTest::newRow("phParallelGeometry") << true;
+}
+
+/*
+  Measures full replots of 32 graphs with 1,000,000 points each, with and without
+  QCP::phParallelGeometry. Afterwards, one replot is recorded with QCPProfiler, and the durations of
+  the "geometry" span of prepareGraphGeometry and of the "layer" spans are printed. Without the
+  hint, the geometry is computed inside the layer spans while drawing.
+*/
+void TestQCustomPlot::graphGeometryScaling()
+{
+  QFETCH(bool, parallel);
+
+  QCustomPlot plot;
+  plot.resize(1600, 1200);
+  std::mt19937 rng(41);
+  std::normal_distribution<double> noise(0.0, 1.0);
+  for (int graphIndex=0; graphIndex<32; ++graphIndex)
+  {
+    QVector<QCPGraphData> points(1000000);
+    double value = graphIndex*100;
+    for (int i=0; i<points.size(); ++i)
+    {
+      value += noise(rng);
+      points[i] = QCPGraphData(i, value);
+    }
+    QSharedPointer<QCPGraphDataContainer> data(new QCPGraphDataContainer);
+    data->set(points, true);
+    plot.addGraph()->setData(data);
+  }
+  plot.rescaleAxes();
+  plot.setPlottingHint(QCP::phParallelGeometry, parallel);
+  plot.replot(); // sets up the paint buffers
+  QBENCHMARK { plot.replot(); }
+
+  plot.setProfilingEnabled(true);
+  plot.replot();
+  qint64 geometryTime = 0;
+  qint64 layerTime = 0;
+  const QList<QCPProfiler::Event> frame = plot.profiler()->lastFrame();
+  for (int i=0; i<frame.size(); ++i)
+  {
+    if (frame.at(i).category == QLatin1String("geometry") && frame.at(i).name == QLatin1String("prepareGraphGeometry"))
+      geometryTime += frame.at(i).duration;
+    else if (frame.at(i).category == QLatin1String("layer"))
+      layerTime += frame.at(i).duration;
+  }
+  qDebug() << "prepareGraphGeometry:" << geometryTime*1e-6 << "ms, layers:" << layerTime*1e-6 << "ms";
+}
+
+QTEST_MAIN(TestQCustomPlot)
+#include "tst_qcustomplot.moc"
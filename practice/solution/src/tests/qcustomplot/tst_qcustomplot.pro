@@ -0,0 +1,31 @@
+#/***************************************************
+# Water Research Module
+# <https://github.com/TonyCooT/water_research_module>
+#
+# ***************************************************
+# Accuracy tests and benchmarks for the rendering optimizations of the bundled QCustomPlot.
+#
+# Run the tests with:       qmake && make && ./tst_qcustomplot
+# Run only the benchmarks:  ./tst_qcustomplot -iterations 20 <benchmark function>
+#
+# Apache License 2.0.
+# See <https://www.apache.org/licenses/> for details.
+# All above must be included in any redistribution.
+# ****************************************************/
+
+QT       += core gui testlib
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets printsupport
+
+CONFIG += c++17 testcase
+
+TARGET = tst_qcustomplot
+
+INCLUDEPATH += ../../app
+
+SOURCES += \
+    tst_qcustomplot.cpp \
+    ../../app/qcustomplot.cpp
+
+HEADERS += \
+    ../../app/qcustomplot.h